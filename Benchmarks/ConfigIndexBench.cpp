@@ -0,0 +1,224 @@
+// Picks the active config for many (model, plate) pairs, once through
+// CConfigIndex and once with the linear search it replaced, checks both
+// pick the same config and reports the time per lookup.
+
+#include <ConfigIndex.hpp>
+#include <Util/Logger.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        int Configs = 10000;
+        int Lookups = 100000;
+    };
+
+    struct SLookup {
+        Hash Model;
+        std::string Plate;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVConfigIndexBench [options]\n"
+            "  --configs <n>       Number of configs (default 10000)\n"
+            "  --lookups <n>       Number of lookups to time (default 100000)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--configs" && hasValue) {
+                options.Configs = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--lookups" && hasValue) {
+                options.Lookups = std::max(1, std::stoi(argv[++i]));
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // StrUtil::Strcmpwi, which needs Windows for its other helpers.
+    bool strcmpwi(std::string a, std::string b) {
+        auto trim = [](std::string& s) {
+            auto isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
+            s.erase(s.begin(), std::find_if_not(s.begin(), s.end(), isSpace));
+            s.erase(std::find_if_not(s.rbegin(), s.rend(), isSpace).base(), s.end());
+        };
+        auto lower = [](std::string& s) {
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+        };
+        trim(a);
+        trim(b);
+        lower(a);
+        lower(b);
+        return a == b;
+    }
+
+    // The search UpdateActiveConfig() did before CConfigIndex.
+    CConfig* findLinear(std::list<CConfig>& configs, Hash model, const char* plateText) {
+        std::string plate = plateText;
+
+        // First pass - match model and plate
+        auto foundConfig = std::find_if(configs.begin(), configs.end(), [&](const CConfig& config) {
+            return config.ModelHash == model && strcmpwi(config.Plate, plate);
+        });
+
+        // second pass - match model with any plate
+        if (foundConfig == configs.end()) {
+            foundConfig = std::find_if(configs.begin(), configs.end(), [&](const CConfig& config) {
+                return config.ModelHash == model && config.Plate.empty();
+            });
+        }
+
+        return foundConfig == configs.end() ? nullptr : &*foundConfig;
+    }
+
+    std::string randomPlate(std::mt19937& rng) {
+        const char chars[] = "ABCDEFGHJKLMNPQRSTUVWXYZ0123456789";
+        std::uniform_int_distribution<size_t> pick(0, sizeof(chars) - 2);
+        std::string plate(8, ' ');
+        for (char& c : plate) {
+            c = chars[pick(rng)];
+        }
+        return plate;
+    }
+
+    // A quarter of the configs are plate specific, like a large config folder
+    // with a few personal cars.
+    void makeConfigs(int count, std::mt19937& rng, std::list<CConfig>& configs) {
+        std::uniform_int_distribution<Hash> hash(1);
+        for (int i = 0; i < count; ++i) {
+            CConfig& config = configs.emplace_back();
+            config.Name = "Config" + std::to_string(i);
+            config.ModelHash = hash(rng);
+            if (i % 4 == 0) {
+                config.Plate = randomPlate(rng);
+            }
+        }
+    }
+
+    // Plate matches, plate mismatches (model-only or default), padded and
+    // lowercase plates, and unknown models, shuffled.
+    std::vector<SLookup> makeLookups(int count, std::mt19937& rng, const std::list<CConfig>& configs) {
+        std::vector<const CConfig*> pool;
+        for (const auto& config : configs) {
+            pool.push_back(&config);
+        }
+
+        std::uniform_int_distribution<size_t> pickConfig(0, pool.size() - 1);
+        std::uniform_int_distribution<Hash> hash(1);
+        std::vector<SLookup> lookups;
+        lookups.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            const CConfig& config = *pool[pickConfig(rng)];
+            switch (i % 4) {
+                case 0:
+                    lookups.push_back({ config.ModelHash, config.Plate.empty() ? randomPlate(rng) : config.Plate });
+                    break;
+                case 1: {
+                    std::string plate = " " + (config.Plate.empty() ? randomPlate(rng) : config.Plate) + " ";
+                    std::transform(plate.begin(), plate.end(), plate.begin(), [](unsigned char c) {
+                        return static_cast<char>(std::tolower(c));
+                    });
+                    lookups.push_back({ config.ModelHash, plate });
+                    break;
+                }
+                case 2:
+                    lookups.push_back({ config.ModelHash, randomPlate(rng) });
+                    break;
+                default:
+                    lookups.push_back({ hash(rng), randomPlate(rng) });
+                    break;
+            }
+        }
+        std::shuffle(lookups.begin(), lookups.end(), rng);
+        return lookups;
+    }
+
+    template <typename Find>
+    double timeLookups(const std::vector<SLookup>& lookups, Find find) {
+        using clock = std::chrono::steady_clock;
+        size_t found = 0;
+        const auto start = clock::now();
+        for (const auto& lookup : lookups) {
+            found += find(lookup) != nullptr;
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        // Keeps the loop from being optimized away.
+        if (found > lookups.size()) {
+            std::puts("");
+        }
+        return elapsed / static_cast<double>(lookups.size());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    g_Logger.SetMinLevel(ERROR);
+
+    std::mt19937 rng(1234);
+    std::list<CConfig> configs;
+    makeConfigs(options.Configs, rng, configs);
+
+    CConfigIndex index;
+    const auto buildStart = std::chrono::steady_clock::now();
+    index.Build(configs);
+    const auto buildTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - buildStart).count();
+
+    const std::vector<SLookup> lookups = makeLookups(options.Lookups, rng, configs);
+
+    // The linear search is slow with many configs, so it's checked and timed on fewer lookups.
+    const size_t linearCount = std::min<size_t>(lookups.size(), 2000);
+    const std::vector<SLookup> linearLookups(lookups.begin(), lookups.begin() + linearCount);
+
+    size_t mismatches = 0;
+    for (const auto& lookup : linearLookups) {
+        if (index.Find(lookup.Model, lookup.Plate) != findLinear(configs, lookup.Model, lookup.Plate.c_str())) {
+            ++mismatches;
+        }
+    }
+
+    const double linearTime = timeLookups(linearLookups, [&](const SLookup& lookup) {
+        return findLinear(configs, lookup.Model, lookup.Plate.c_str());
+    });
+    const double indexTime = timeLookups(lookups, [&](const SLookup& lookup) {
+        return index.Find(lookup.Model, lookup.Plate);
+    });
+
+    std::printf("%d configs, index built in %.0f us\n", options.Configs, buildTime);
+    std::printf("%-10s %10s %12s\n", "Search", "Lookups", "ns/lookup");
+    std::printf("%-10s %10zu %12.1f\n", "linear", linearLookups.size(), linearTime);
+    std::printf("%-10s %10zu %12.1f\n", "index", lookups.size(), indexTime);
+
+    if (mismatches > 0) {
+        std::cerr << mismatches << " of " << linearCount << " lookups found a different config\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Times LOG() calls that are filtered at compile time, filtered at runtime,
+// and written, and checks filtered calls don't evaluate their arguments.
+// Built twice, with LOG_MIN_LEVEL 0 (debug builds) and 1 (release builds).
+
+#include <Util/Logger.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+    struct SOptions {
+        int Calls = 1000000;
+    };
+
+    struct SCase {
+        const char* Name;
+        LogLevel Level;
+        LogLevel MinLevel;
+    };
+
+    // Stays below the writer queue size, so written calls aren't dropped.
+    constexpr int writtenBatch = 1000;
+
+    int evaluations = 0;
+
+    // Stands in for an argument that's costly to produce.
+    std::string describe(int i) {
+        ++evaluations;
+        return "value " + std::to_string(i);
+    }
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVLogBench" << LOG_MIN_LEVEL << " [options]\n"
+            "  --calls <n>         Filtered calls per case (default 1000000)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--calls" && hasValue) {
+                options.Calls = std::max(1, std::stoi(argv[++i]));
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // LOG() needs the level as a constant to filter at compile time.
+    void logOnce(LogLevel level, int i) {
+        switch (level) {
+            case DEBUG:
+                LOG(DEBUG, "[Bench] {} {:.3f}", describe(i), i * 0.5);
+                break;
+            case INFO:
+                LOG(INFO, "[Bench] {} {:.3f}", describe(i), i * 0.5);
+                break;
+            default:
+                LOG(WARN, "[Bench] {} {:.3f}", describe(i), i * 0.5);
+                break;
+        }
+    }
+
+    bool compiledOut(LogLevel level) {
+        return level < LOG_MIN_LEVEL;
+    }
+
+    bool filtered(const SCase& c) {
+        return compiledOut(c.Level) || c.Level < c.MinLevel;
+    }
+
+    double timeCalls(const SCase& c, int calls) {
+        using clock = std::chrono::steady_clock;
+        g_Logger.SetMinLevel(c.MinLevel);
+
+        double elapsed = 0.0;
+        for (int done = 0; done < calls;) {
+            const int batch = filtered(c) ? calls : std::min(writtenBatch, calls - done);
+            const auto start = clock::now();
+            for (int i = done; i < done + batch; ++i) {
+                logOnce(c.Level, i);
+            }
+            elapsed += std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            done += batch;
+
+            if (!filtered(c)) {
+                // Let the writer drain the queue, outside of the timing.
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+        return elapsed / static_cast<double>(calls);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    const auto logFile = std::filesystem::temp_directory_path() / "FPVLogBench.log";
+    g_Logger.SetFile(logFile.string());
+    g_Logger.Clear();
+    g_Logger.Start();
+
+    const SCase cases[] = {
+        { "DEBUG, min DEBUG", DEBUG, DEBUG },
+        { "DEBUG, min INFO", DEBUG, INFO },
+        { "INFO, min WARN", INFO, WARN },
+        { "INFO, min INFO", INFO, INFO },
+    };
+
+    std::printf("LOG_MIN_LEVEL %d\n", LOG_MIN_LEVEL);
+    std::printf("%-18s %-10s %10s %10s\n", "Call", "Result", "Calls", "ns/call");
+
+    bool argumentsEvaluated = false;
+    for (const SCase& c : cases) {
+        const int calls = filtered(c) ? options.Calls : std::min(options.Calls, 10 * writtenBatch);
+        evaluations = 0;
+        const double time = timeCalls(c, calls);
+
+        const char* result = compiledOut(c.Level) ? "compiled" : filtered(c) ? "filtered" : "written";
+        std::printf("%-18s %-10s %10d %10.2f\n", c.Name, result, calls, time);
+
+        if (filtered(c) && evaluations != 0) {
+            std::cerr << c.Name << ": " << evaluations << " filtered calls evaluated their arguments\n";
+            argumentsEvaluated = true;
+        }
+    }
+
+    g_Logger.Shutdown(false);
+    return argumentsEvaluated ? 1 : 0;
+}
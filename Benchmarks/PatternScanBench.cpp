@@ -0,0 +1,202 @@
+// Scans a synthetic buffer with byte frequencies roughly like x64 code,
+// with ScanPattern, ScanPatterns and a brute-force search. Checks all three
+// find the same addresses and reports the time each took. Then times
+// ScanPatterns for 4 to 64 patterns, which should stay about the same.
+
+#include <Memory/PatternScan.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        size_t SizeMb = 80;
+        int Patterns = 16;
+        unsigned Threads = 0;
+        unsigned Seed = 1234;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVPatternScanBench [options]\n"
+            "  --size <MB>         Buffer size (default 80)\n"
+            "  --patterns <n>      Number of patterns (default 16)\n"
+            "  --threads <n>       Threads for ScanPatterns (default 0: hardware concurrency)\n"
+            "  --seed <n>          Seed for the buffer and patterns (default 1234)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--size" && hasValue) {
+                options.SizeMb = static_cast<size_t>(std::max(1, std::stoi(argv[++i])));
+            }
+            else if (arg == "--patterns" && hasValue) {
+                options.Patterns = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--threads" && hasValue) {
+                options.Threads = static_cast<unsigned>(std::max(0, std::stoi(argv[++i])));
+            }
+            else if (arg == "--seed" && hasValue) {
+                options.Seed = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Half the bytes come from the ones that are common in game code,
+    // so the anchors see realistic false candidates.
+    std::vector<uint8_t> makeBuffer(size_t size, std::mt19937& rng) {
+        constexpr uint8_t common[] = {
+            0x00, 0xFF, 0x48, 0x8B, 0x0F, 0xCC, 0x89, 0x24, 0x4C, 0x44, 0xE8, 0x85,
+            0xC0, 0x01, 0x08, 0x83, 0x10, 0x20, 0x8D, 0x45, 0x41, 0x49, 0x4D, 0xC3,
+        };
+        std::uniform_int_distribution<int> coin(0, 1);
+        std::uniform_int_distribution<size_t> pickCommon(0, sizeof(common) - 1);
+        std::uniform_int_distribution<int> anyByte(0, 255);
+
+        std::vector<uint8_t> buffer(size);
+        for (auto& byte : buffer) {
+            byte = coin(rng) ? common[pickCommon(rng)] : static_cast<uint8_t>(anyByte(rng));
+        }
+        return buffer;
+    }
+
+    // Copies of the buffer at random places with some wildcards, so each has
+    // a match there or earlier. Every fourth one gets its first byte changed,
+    // so most of those scan the whole buffer without a match.
+    std::vector<Memory::SPattern> makePatterns(const std::vector<uint8_t>& buffer, int count, std::mt19937& rng) {
+        std::uniform_int_distribution<size_t> length(6, 24);
+        std::uniform_int_distribution<int> wildcard(0, 3);
+        std::vector<Memory::SPattern> patterns;
+        for (int i = 0; i < count; ++i) {
+            const size_t patternLength = length(rng);
+            std::uniform_int_distribution<size_t> offset(0, buffer.size() - patternLength);
+            const size_t start = offset(rng);
+
+            std::string bytes;
+            std::string mask;
+            for (size_t j = 0; j < patternLength; ++j) {
+                const bool isWildcard = j > 0 && wildcard(rng) == 0;
+                bytes.push_back(static_cast<char>(buffer[start + j]));
+                mask.push_back(isWildcard ? '?' : 'x');
+            }
+            if (i % 4 == 3) {
+                bytes[0] = static_cast<char>(static_cast<uint8_t>(bytes[0]) ^ 0x5A);
+            }
+            patterns.push_back(Memory::ParsePattern(bytes.data(), mask.c_str()));
+        }
+        return patterns;
+    }
+
+    const uint8_t* bruteForce(const uint8_t* begin, const uint8_t* end, const Memory::SPattern& pattern) {
+        const size_t length = pattern.Bytes.size();
+        for (const uint8_t* address = begin; address + length <= end; ++address) {
+            bool match = true;
+            for (size_t i = 0; i < length && match; ++i) {
+                match = !pattern.Mask[i] || address[i] == pattern.Bytes[i];
+            }
+            if (match) {
+                return address;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Scan>
+    double timeMs(Scan scan) {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        scan();
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    std::mt19937 rng(options.Seed);
+    const std::vector<uint8_t> buffer = makeBuffer(options.SizeMb * 1024 * 1024, rng);
+    const std::vector<Memory::SPattern> patterns = makePatterns(buffer, options.Patterns, rng);
+    const uint8_t* begin = buffer.data();
+    const uint8_t* end = begin + buffer.size();
+
+    std::vector<const uint8_t*> expected(patterns.size());
+    std::vector<const uint8_t*> single(patterns.size());
+    std::vector<const uint8_t*> multi;
+
+    const double bruteTime = timeMs([&] {
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            expected[i] = bruteForce(begin, end, patterns[i]);
+        }
+    });
+    const double singleTime = timeMs([&] {
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            single[i] = Memory::ScanPattern(begin, end, patterns[i]);
+        }
+    });
+    const double multiTime = timeMs([&] {
+        multi = Memory::ScanPatterns(begin, end, patterns, options.Threads);
+    });
+
+    int mismatches = 0;
+    int found = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        found += expected[i] != nullptr;
+        if (single[i] != expected[i] || multi[i] != expected[i]) {
+            std::cerr << "Pattern " << i << ": brute force " << (expected[i] ? expected[i] - begin : -1)
+                << ", ScanPattern " << (single[i] ? single[i] - begin : -1)
+                << ", ScanPatterns " << (multi[i] ? multi[i] - begin : -1) << '\n';
+            ++mismatches;
+        }
+    }
+
+    std::printf("%zu MB, %zu patterns, %d found\n", options.SizeMb, patterns.size(), found);
+    std::printf("%-14s %10s %12s\n", "Scan", "ms", "ms/pattern");
+    const double count = static_cast<double>(patterns.size());
+    std::printf("%-14s %10.1f %12.2f\n", "brute force", bruteTime, bruteTime / count);
+    std::printf("%-14s %10.1f %12.2f\n", "ScanPattern", singleTime, singleTime / count);
+    std::printf("%-14s %10.1f %12.2f\n", "ScanPatterns", multiTime, multiTime / count);
+
+    // Checked against ScanPattern, brute force takes too long for 64.
+    std::printf("\n%-14s %10s %12s\n", "ScanPatterns", "ms", "ms/pattern");
+    for (int sweepCount : { 4, 16, 64 }) {
+        const std::vector<Memory::SPattern> sweepPatterns = makePatterns(buffer, sweepCount, rng);
+        std::vector<const uint8_t*> sweepResults;
+        const double sweepTime = timeMs([&] {
+            sweepResults = Memory::ScanPatterns(begin, end, sweepPatterns, options.Threads);
+        });
+        for (size_t i = 0; i < sweepPatterns.size(); ++i) {
+            const uint8_t* reference = Memory::ScanPattern(begin, end, sweepPatterns[i]);
+            if (sweepResults[i] != reference) {
+                std::cerr << sweepCount << " patterns, pattern " << i << ": ScanPattern "
+                    << (reference ? reference - begin : -1)
+                    << ", ScanPatterns " << (sweepResults[i] ? sweepResults[i] - begin : -1) << '\n';
+                ++mismatches;
+            }
+        }
+        std::printf("%-14s %10.1f %12.2f\n", (std::to_string(sweepCount) + " patterns").c_str(),
+            sweepTime, sweepTime / sweepCount);
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// Samples the camera shake channels with CShakeNoise and with the three
+// PerlinNoise::noise() calls it replaced. Checks the samples and their mean,
+// variance and lag-1 autocorrelation match, near t = 0 and at a late time,
+// and reports the time per tick of both.
+
+#include <Util/ShakeNoise.hpp>
+#include <PerlinNoise.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        int Samples = 100000;
+        double Step = 0.02;
+        double LateTime = 1.0e6;
+    };
+
+    // Side, vertical and roll z offsets, as the script passes them.
+    constexpr double offsets[3] = { 3.3f, 4.2f, 6.9f };
+    constexpr const char* channelNames[3] = { "side", "vert", "roll" };
+
+    constexpr double maxSampleDiff = 1.0e-5;
+    constexpr double maxStatDiff = 1.0e-4;
+
+    struct SStats {
+        double Mean = 0.0;
+        double Variance = 0.0;
+        double Autocorrelation = 0.0;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVShakeNoiseBench [options]\n"
+            "  --samples <n>       Samples per run (default 100000)\n"
+            "  --step <s>          Noise time between samples (default 0.02)\n"
+            "  --late <s>          Start time of the late run (default 1e6)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--samples" && hasValue) {
+                options.Samples = std::max(2, std::stoi(argv[++i]));
+            }
+            else if (arg == "--step" && hasValue) {
+                options.Step = std::stod(argv[++i]);
+            }
+            else if (arg == "--late" && hasValue) {
+                options.LateTime = std::stod(argv[++i]);
+            }
+            else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // What getShakeFromSpeed() and getShakeFromTerrain() did before CShakeNoise.
+    void sampleReference(PerlinNoise& perlin, double time, double (&out)[3]) {
+        const double x = std::cos(time);
+        const double y = std::sin(time);
+        for (int i = 0; i < 3; ++i) {
+            out[i] = perlin.noise(x, y, offsets[i] + time) - 0.5;
+        }
+    }
+
+    SStats computeStats(const std::vector<double>& values) {
+        SStats stats;
+        const double count = static_cast<double>(values.size());
+        for (double value : values) {
+            stats.Mean += value;
+        }
+        stats.Mean /= count;
+
+        double lagSum = 0.0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double d = values[i] - stats.Mean;
+            stats.Variance += d * d;
+            if (i > 0) {
+                lagSum += d * (values[i - 1] - stats.Mean);
+            }
+        }
+        stats.Autocorrelation = stats.Variance > 0.0 ? lagSum / stats.Variance : 0.0;
+        stats.Variance /= count;
+        return stats;
+    }
+
+    // Compares both over one run and prints a row per channel.
+    // Returns false if the samples or the statistics differ too much.
+    bool compareRun(const char* name, double start, const SOptions& options,
+                    PerlinNoise& perlin, const CShakeNoise& shakeNoise) {
+        std::vector<double> reference[3];
+        std::vector<double> shake[3];
+        double maxDiff[3] = {};
+        for (int c = 0; c < 3; ++c) {
+            reference[c].reserve(options.Samples);
+            shake[c].reserve(options.Samples);
+        }
+
+        for (int i = 0; i < options.Samples; ++i) {
+            const double time = start + i * options.Step;
+            double expected[3];
+            sampleReference(perlin, time, expected);
+            const CShakeNoise::SSample sample = shakeNoise.Sample(time);
+            const double actual[3] = { sample.Side, sample.Vert, sample.Roll };
+            for (int c = 0; c < 3; ++c) {
+                reference[c].push_back(expected[c]);
+                shake[c].push_back(actual[c]);
+                maxDiff[c] = std::max(maxDiff[c], std::abs(actual[c] - expected[c]));
+            }
+        }
+
+        bool match = true;
+        for (int c = 0; c < 3; ++c) {
+            const SStats ref = computeStats(reference[c]);
+            const SStats act = computeStats(shake[c]);
+            std::printf("%-6s %-5s %10.2e %10.6f %10.6f %10.6f %10.6f %10.6f %10.6f\n",
+                name, channelNames[c], maxDiff[c],
+                ref.Mean, act.Mean, ref.Variance, act.Variance, ref.Autocorrelation, act.Autocorrelation);
+
+            const bool sampleMatch = maxDiff[c] <= maxSampleDiff;
+            const bool statsMatch =
+                std::abs(act.Mean - ref.Mean) <= maxStatDiff &&
+                std::abs(act.Variance - ref.Variance) <= maxStatDiff * ref.Variance &&
+                std::abs(act.Autocorrelation - ref.Autocorrelation) <= maxStatDiff;
+            if (!sampleMatch || !statsMatch) {
+                std::cerr << name << " " << channelNames[c] << ": "
+                    << (sampleMatch ? "statistics" : "samples") << " differ from PerlinNoise\n";
+                match = false;
+            }
+        }
+        return match;
+    }
+
+    template <typename Sample>
+    double timeTicks(const SOptions& options, Sample sample) {
+        using clock = std::chrono::steady_clock;
+        double sum = 0.0;
+        const auto start = clock::now();
+        for (int i = 0; i < options.Samples; ++i) {
+            sum += sample(i * options.Step);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        // Keeps the loop from being optimized away.
+        if (sum == 1.0e300) {
+            std::puts("");
+        }
+        return elapsed / static_cast<double>(options.Samples);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    PerlinNoise perlin;
+    const CShakeNoise shakeNoise(offsets[0], offsets[1], offsets[2]);
+
+    std::printf("%d samples, step %.3f\n", options.Samples, options.Step);
+    std::printf("%-6s %-5s %10s %10s %10s %10s %10s %10s %10s\n", "Run", "Chan", "max diff",
+        "ref mean", "mean", "ref var", "var", "ref lag-1", "lag-1");
+    bool match = compareRun("start", 0.0, options, perlin, shakeNoise);
+    match = compareRun("late", options.LateTime, options, perlin, shakeNoise) && match;
+
+    const double referenceTime = timeTicks(options, [&](double time) {
+        double out[3];
+        sampleReference(perlin, time, out);
+        return out[0] + out[1] + out[2];
+    });
+    const double shakeTime = timeTicks(options, [&](double time) {
+        const CShakeNoise::SSample sample = shakeNoise.Sample(time);
+        return static_cast<double>(sample.Side + sample.Vert + sample.Roll);
+    });
+
+    std::printf("%-12s %10s\n", "Noise", "ns/tick");
+    std::printf("%-12s %10.1f\n", "PerlinNoise", referenceTime);
+    std::printf("%-12s %10.1f\n", "CShakeNoise", shakeTime);
+
+    return match ? 0 : 1;
+}
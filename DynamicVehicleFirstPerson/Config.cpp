@@ -7,8 +7,11 @@
 #include "Util/Strings.hpp"
 
 #include <simpleini/SimpleIni.h>
-#include <filesystem>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
 using std::to_underlying;
 
@@ -41,143 +44,226 @@ CConfig::EMountPoint GetValue(CSimpleIniA& ini, const std::string& section, cons
 }
 
 #define SAVE_VAL_LEAN(section, source) { \
-    SAVE_VAL(section, "CenterDist",  ##source.CenterDist); \
-    SAVE_VAL(section, "ForwardDist", ##source.ForwardDist); \
-    SAVE_VAL(section, "UpDist",      ##source.UpDist); \
+    SAVE_VAL(section, "CenterDist",  source.CenterDist); \
+    SAVE_VAL(section, "ForwardDist", source.ForwardDist); \
+    SAVE_VAL(section, "UpDist",      source.UpDist); \
 }
 
 #define LOAD_VAL_LEAN(section, source) { \
-    LOAD_VAL(section, "CenterDist",  ##source.CenterDist); \
-    LOAD_VAL(section, "ForwardDist", ##source.ForwardDist); \
-    LOAD_VAL(section, "UpDist",      ##source.UpDist); \
+    LOAD_VAL(section, "CenterDist",  source.CenterDist); \
+    LOAD_VAL(section, "ForwardDist", source.ForwardDist); \
+    LOAD_VAL(section, "UpDist",      source.UpDist); \
 }
 
 #define SAVE_VAL_MOVEMENT(section, source) { \
-    SAVE_VAL(section, "Follow",            ##source.Follow); \
-    SAVE_VAL(section, "RotationDirectionMult", ##source.RotationDirectionMult); \
-    SAVE_VAL(section, "RotationRotationMult",  ##source.RotationRotationMult); \
-    SAVE_VAL(section, "RotationMaxAngle",      ##source.RotationMaxAngle); \
-    SAVE_VAL(section, "LongDeadzone",      ##source.LongDeadzone); \
-    SAVE_VAL(section, "LongForwardMult",   ##source.LongForwardMult); \
-    SAVE_VAL(section, "LongBackwardMult",  ##source.LongBackwardMult); \
-    SAVE_VAL(section, "LongForwardLimit",  ##source.LongForwardLimit); \
-    SAVE_VAL(section, "LongBackwardLimit", ##source.LongBackwardLimit); \
-    SAVE_VAL(section, "PitchDeadzone",     ##source.PitchDeadzone); \
-    SAVE_VAL(section, "PitchUpMult",       ##source.PitchUpMult); \
-    SAVE_VAL(section, "PitchDownMult",     ##source.PitchDownMult); \
-    SAVE_VAL(section, "PitchUpMaxAngle",   ##source.PitchUpMaxAngle); \
-    SAVE_VAL(section, "PitchDownMaxAngle", ##source.PitchDownMaxAngle); \
-    SAVE_VAL(section, "LatDeadzone",       ##source.LatDeadzone); \
-    SAVE_VAL(section, "LatMult",           ##source.LatMult); \
-    SAVE_VAL(section, "LatLimit",          ##source.LatLimit); \
-    SAVE_VAL(section, "VertDeadzone",      ##source.VertDeadzone); \
-    SAVE_VAL(section, "VertUpMult",        ##source.VertUpMult); \
-    SAVE_VAL(section, "VertDownMult",      ##source.VertDownMult); \
-    SAVE_VAL(section, "VertUpLimit",       ##source.VertUpLimit); \
-    SAVE_VAL(section, "VertDownLimit",     ##source.VertDownLimit); \
-    SAVE_VAL(section, "Roughness",         ##source.Roughness); \
-    SAVE_VAL(section, "ShakeSpeed",        ##source.ShakeSpeed); \
-    SAVE_VAL(section, "ShakeTerrain",      ##source.ShakeTerrain); \
+    SAVE_VAL(section, "Follow",            source.Follow); \
+    SAVE_VAL(section, "RotationDirectionMult", source.RotationDirectionMult); \
+    SAVE_VAL(section, "RotationRotationMult",  source.RotationRotationMult); \
+    SAVE_VAL(section, "RotationMaxAngle",      source.RotationMaxAngle); \
+    SAVE_VAL(section, "LongDeadzone",      source.LongDeadzone); \
+    SAVE_VAL(section, "LongForwardMult",   source.LongForwardMult); \
+    SAVE_VAL(section, "LongBackwardMult",  source.LongBackwardMult); \
+    SAVE_VAL(section, "LongForwardLimit",  source.LongForwardLimit); \
+    SAVE_VAL(section, "LongBackwardLimit", source.LongBackwardLimit); \
+    SAVE_VAL(section, "PitchDeadzone",     source.PitchDeadzone); \
+    SAVE_VAL(section, "PitchUpMult",       source.PitchUpMult); \
+    SAVE_VAL(section, "PitchDownMult",     source.PitchDownMult); \
+    SAVE_VAL(section, "PitchUpMaxAngle",   source.PitchUpMaxAngle); \
+    SAVE_VAL(section, "PitchDownMaxAngle", source.PitchDownMaxAngle); \
+    SAVE_VAL(section, "LatDeadzone",       source.LatDeadzone); \
+    SAVE_VAL(section, "LatMult",           source.LatMult); \
+    SAVE_VAL(section, "LatLimit",          source.LatLimit); \
+    SAVE_VAL(section, "VertDeadzone",      source.VertDeadzone); \
+    SAVE_VAL(section, "VertUpMult",        source.VertUpMult); \
+    SAVE_VAL(section, "VertDownMult",      source.VertDownMult); \
+    SAVE_VAL(section, "VertUpLimit",       source.VertUpLimit); \
+    SAVE_VAL(section, "VertDownLimit",     source.VertDownLimit); \
+    SAVE_VAL(section, "Roughness",         source.Roughness); \
+    SAVE_VAL(section, "ShakeSpeed",        source.ShakeSpeed); \
+    SAVE_VAL(section, "ShakeTerrain",      source.ShakeTerrain); \
 }
 
 #define LOAD_VAL_MOVEMENT(section, source) { \
-    LOAD_VAL(section, "Follow",            ##source.Follow); \
-    LOAD_VAL(section, "RotationDirectionMult", ##source.RotationDirectionMult); \
-    LOAD_VAL(section, "RotationRotationMult",  ##source.RotationRotationMult); \
-    LOAD_VAL(section, "RotationMaxAngle",      ##source.RotationMaxAngle); \
-    LOAD_VAL(section, "LongDeadzone",      ##source.LongDeadzone); \
-    LOAD_VAL(section, "LongForwardMult",   ##source.LongForwardMult); \
-    LOAD_VAL(section, "LongBackwardMult",  ##source.LongBackwardMult); \
-    LOAD_VAL(section, "LongForwardLimit",  ##source.LongForwardLimit); \
-    LOAD_VAL(section, "LongBackwardLimit", ##source.LongBackwardLimit); \
-    LOAD_VAL(section, "PitchDeadzone",     ##source.PitchDeadzone); \
-    LOAD_VAL(section, "PitchUpMult",       ##source.PitchUpMult); \
-    LOAD_VAL(section, "PitchDownMult",     ##source.PitchDownMult); \
-    LOAD_VAL(section, "PitchUpMaxAngle",   ##source.PitchUpMaxAngle); \
-    LOAD_VAL(section, "PitchDownMaxAngle", ##source.PitchDownMaxAngle); \
-    LOAD_VAL(section, "LatDeadzone",       ##source.LatDeadzone); \
-    LOAD_VAL(section, "LatMult",           ##source.LatMult); \
-    LOAD_VAL(section, "LatLimit",          ##source.LatLimit); \
-    LOAD_VAL(section, "VertDeadzone",      ##source.VertDeadzone); \
-    LOAD_VAL(section, "VertUpMult",        ##source.VertUpMult); \
-    LOAD_VAL(section, "VertDownMult",      ##source.VertDownMult); \
-    LOAD_VAL(section, "VertUpLimit",       ##source.VertUpLimit); \
-    LOAD_VAL(section, "VertDownLimit",     ##source.VertDownLimit); \
-    LOAD_VAL(section, "Roughness",         ##source.Roughness); \
-    LOAD_VAL(section, "ShakeSpeed",        ##source.ShakeSpeed); \
-    LOAD_VAL(section, "ShakeTerrain",      ##source.ShakeTerrain); \
+    LOAD_VAL(section, "Follow",            source.Follow); \
+    LOAD_VAL(section, "RotationDirectionMult", source.RotationDirectionMult); \
+    LOAD_VAL(section, "RotationRotationMult",  source.RotationRotationMult); \
+    LOAD_VAL(section, "RotationMaxAngle",      source.RotationMaxAngle); \
+    LOAD_VAL(section, "LongDeadzone",      source.LongDeadzone); \
+    LOAD_VAL(section, "LongForwardMult",   source.LongForwardMult); \
+    LOAD_VAL(section, "LongBackwardMult",  source.LongBackwardMult); \
+    LOAD_VAL(section, "LongForwardLimit",  source.LongForwardLimit); \
+    LOAD_VAL(section, "LongBackwardLimit", source.LongBackwardLimit); \
+    LOAD_VAL(section, "PitchDeadzone",     source.PitchDeadzone); \
+    LOAD_VAL(section, "PitchUpMult",       source.PitchUpMult); \
+    LOAD_VAL(section, "PitchDownMult",     source.PitchDownMult); \
+    LOAD_VAL(section, "PitchUpMaxAngle",   source.PitchUpMaxAngle); \
+    LOAD_VAL(section, "PitchDownMaxAngle", source.PitchDownMaxAngle); \
+    LOAD_VAL(section, "LatDeadzone",       source.LatDeadzone); \
+    LOAD_VAL(section, "LatMult",           source.LatMult); \
+    LOAD_VAL(section, "LatLimit",          source.LatLimit); \
+    LOAD_VAL(section, "VertDeadzone",      source.VertDeadzone); \
+    LOAD_VAL(section, "VertUpMult",        source.VertUpMult); \
+    LOAD_VAL(section, "VertDownMult",      source.VertDownMult); \
+    LOAD_VAL(section, "VertUpLimit",       source.VertUpLimit); \
+    LOAD_VAL(section, "VertDownLimit",     source.VertDownLimit); \
+    LOAD_VAL(section, "Roughness",         source.Roughness); \
+    LOAD_VAL(section, "ShakeSpeed",        source.ShakeSpeed); \
+    LOAD_VAL(section, "ShakeTerrain",      source.ShakeTerrain); \
 }
 
 #define SAVE_VAL_HORIZON(section, source) { \
-    SAVE_VAL(section, "Lock",        ##source.Lock); \
-    SAVE_VAL(section, "PitchMode",   ##source.PitchMode); \
-    SAVE_VAL(section, "CenterSpeed", ##source.CenterSpeed); \
-    SAVE_VAL(section, "PitchLim",    ##source.PitchLim); \
-    SAVE_VAL(section, "RollLim",     ##source.RollLim); \
+    SAVE_VAL(section, "Lock",        source.Lock); \
+    SAVE_VAL(section, "PitchMode",   source.PitchMode); \
+    SAVE_VAL(section, "CenterSpeed", source.CenterSpeed); \
+    SAVE_VAL(section, "PitchLim",    source.PitchLim); \
+    SAVE_VAL(section, "RollLim",     source.RollLim); \
 }
 
 #define LOAD_VAL_HORIZON(section, source) { \
-    LOAD_VAL(section, "Lock",        ##source.Lock); \
-    LOAD_VAL(section, "PitchMode",   ##source.PitchMode); \
-    LOAD_VAL(section, "CenterSpeed", ##source.CenterSpeed); \
-    LOAD_VAL(section, "PitchLim",    ##source.PitchLim); \
-    LOAD_VAL(section, "RollLim",     ##source.RollLim); \
+    LOAD_VAL(section, "Lock",        source.Lock); \
+    LOAD_VAL(section, "PitchMode",   source.PitchMode); \
+    LOAD_VAL(section, "CenterSpeed", source.CenterSpeed); \
+    LOAD_VAL(section, "PitchLim",    source.PitchLim); \
+    LOAD_VAL(section, "RollLim",     source.RollLim); \
 }
 
 #define SAVE_VAL_DOF(section, source) { \
-    SAVE_VAL(section, "Enable",                   ##source.Enable); \
-    SAVE_VAL(section, "TargetSpeedMinDoF",        ##source.TargetSpeedMinDoF); \
-    SAVE_VAL(section, "TargetSpeedMaxDoF",        ##source.TargetSpeedMaxDoF); \
-    SAVE_VAL(section, "TargetAccelMinDoF",        ##source.TargetAccelMinDoF); \
-    SAVE_VAL(section, "TargetAccelMaxDoF",        ##source.TargetAccelMaxDoF); \
-    SAVE_VAL(section, "TargetAccelMinDoFMod",     ##source.TargetAccelMinDoFMod); \
-    SAVE_VAL(section, "TargetAccelMaxDoFMod",     ##source.TargetAccelMaxDoFMod); \
-    SAVE_VAL(section, "NearOutFocusMinSpeedDist", ##source.NearOutFocusMinSpeedDist); \
-    SAVE_VAL(section, "NearOutFocusMaxSpeedDist", ##source.NearOutFocusMaxSpeedDist); \
-    SAVE_VAL(section, "NearInFocusMinSpeedDist",  ##source.NearInFocusMinSpeedDist); \
-    SAVE_VAL(section, "NearInFocusMaxSpeedDist",  ##source.NearInFocusMaxSpeedDist); \
-    SAVE_VAL(section, "FarInFocusMinSpeedDist",   ##source.FarInFocusMinSpeedDist); \
-    SAVE_VAL(section, "FarInFocusMaxSpeedDist",   ##source.FarInFocusMaxSpeedDist); \
-    SAVE_VAL(section, "FarOutFocusMinSpeedDist",  ##source.FarOutFocusMinSpeedDist); \
-    SAVE_VAL(section, "FarOutFocusMaxSpeedDist",  ##source.FarOutFocusMaxSpeedDist); \
+    SAVE_VAL(section, "Enable",                   source.Enable); \
+    SAVE_VAL(section, "TargetSpeedMinDoF",        source.TargetSpeedMinDoF); \
+    SAVE_VAL(section, "TargetSpeedMaxDoF",        source.TargetSpeedMaxDoF); \
+    SAVE_VAL(section, "TargetAccelMinDoF",        source.TargetAccelMinDoF); \
+    SAVE_VAL(section, "TargetAccelMaxDoF",        source.TargetAccelMaxDoF); \
+    SAVE_VAL(section, "TargetAccelMinDoFMod",     source.TargetAccelMinDoFMod); \
+    SAVE_VAL(section, "TargetAccelMaxDoFMod",     source.TargetAccelMaxDoFMod); \
+    SAVE_VAL(section, "NearOutFocusMinSpeedDist", source.NearOutFocusMinSpeedDist); \
+    SAVE_VAL(section, "NearOutFocusMaxSpeedDist", source.NearOutFocusMaxSpeedDist); \
+    SAVE_VAL(section, "NearInFocusMinSpeedDist",  source.NearInFocusMinSpeedDist); \
+    SAVE_VAL(section, "NearInFocusMaxSpeedDist",  source.NearInFocusMaxSpeedDist); \
+    SAVE_VAL(section, "FarInFocusMinSpeedDist",   source.FarInFocusMinSpeedDist); \
+    SAVE_VAL(section, "FarInFocusMaxSpeedDist",   source.FarInFocusMaxSpeedDist); \
+    SAVE_VAL(section, "FarOutFocusMinSpeedDist",  source.FarOutFocusMinSpeedDist); \
+    SAVE_VAL(section, "FarOutFocusMaxSpeedDist",  source.FarOutFocusMaxSpeedDist); \
 }
 
 #define LOAD_VAL_DOF(section, source) { \
-    LOAD_VAL(section, "Enable",                   ##source.Enable); \
-    LOAD_VAL(section, "TargetSpeedMinDoF",        ##source.TargetSpeedMinDoF); \
-    LOAD_VAL(section, "TargetSpeedMaxDoF",        ##source.TargetSpeedMaxDoF); \
-    LOAD_VAL(section, "TargetAccelMinDoF",        ##source.TargetAccelMinDoF); \
-    LOAD_VAL(section, "TargetAccelMaxDoF",        ##source.TargetAccelMaxDoF); \
-    LOAD_VAL(section, "TargetAccelMinDoFMod",     ##source.TargetAccelMinDoFMod); \
-    LOAD_VAL(section, "TargetAccelMaxDoFMod",     ##source.TargetAccelMaxDoFMod); \
-    LOAD_VAL(section, "NearOutFocusMinSpeedDist", ##source.NearOutFocusMinSpeedDist); \
-    LOAD_VAL(section, "NearOutFocusMaxSpeedDist", ##source.NearOutFocusMaxSpeedDist); \
-    LOAD_VAL(section, "NearInFocusMinSpeedDist",  ##source.NearInFocusMinSpeedDist); \
-    LOAD_VAL(section, "NearInFocusMaxSpeedDist",  ##source.NearInFocusMaxSpeedDist); \
-    LOAD_VAL(section, "FarInFocusMinSpeedDist",   ##source.FarInFocusMinSpeedDist); \
-    LOAD_VAL(section, "FarInFocusMaxSpeedDist",   ##source.FarInFocusMaxSpeedDist); \
-    LOAD_VAL(section, "FarOutFocusMinSpeedDist",  ##source.FarOutFocusMinSpeedDist); \
-    LOAD_VAL(section, "FarOutFocusMaxSpeedDist",  ##source.FarOutFocusMaxSpeedDist); \
+    LOAD_VAL(section, "Enable",                   source.Enable); \
+    LOAD_VAL(section, "TargetSpeedMinDoF",        source.TargetSpeedMinDoF); \
+    LOAD_VAL(section, "TargetSpeedMaxDoF",        source.TargetSpeedMaxDoF); \
+    LOAD_VAL(section, "TargetAccelMinDoF",        source.TargetAccelMinDoF); \
+    LOAD_VAL(section, "TargetAccelMaxDoF",        source.TargetAccelMaxDoF); \
+    LOAD_VAL(section, "TargetAccelMinDoFMod",     source.TargetAccelMinDoFMod); \
+    LOAD_VAL(section, "TargetAccelMaxDoFMod",     source.TargetAccelMaxDoFMod); \
+    LOAD_VAL(section, "NearOutFocusMinSpeedDist", source.NearOutFocusMinSpeedDist); \
+    LOAD_VAL(section, "NearOutFocusMaxSpeedDist", source.NearOutFocusMaxSpeedDist); \
+    LOAD_VAL(section, "NearInFocusMinSpeedDist",  source.NearInFocusMinSpeedDist); \
+    LOAD_VAL(section, "NearInFocusMaxSpeedDist",  source.NearInFocusMaxSpeedDist); \
+    LOAD_VAL(section, "FarInFocusMinSpeedDist",   source.FarInFocusMinSpeedDist); \
+    LOAD_VAL(section, "FarInFocusMaxSpeedDist",   source.FarInFocusMaxSpeedDist); \
+    LOAD_VAL(section, "FarOutFocusMinSpeedDist",  source.FarOutFocusMinSpeedDist); \
+    LOAD_VAL(section, "FarOutFocusMaxSpeedDist",  source.FarOutFocusMaxSpeedDist); \
 }
 
 #define SAVE_VAL_CAMERA(section, source) { \
-    SAVE_VAL(section, "Order",         ##source.Order); \
-    SAVE_VAL(section, "MountPoint",    ##source.MountPoint); \
-    SAVE_VAL(section, "FOV",           ##source.FOV); \
-    SAVE_VAL(section, "OffsetHeight",  ##source.OffsetHeight); \
-    SAVE_VAL(section, "OffsetForward", ##source.OffsetForward); \
-    SAVE_VAL(section, "OffsetSide",    ##source.OffsetSide); \
-    SAVE_VAL(section, "Pitch",         ##source.Pitch); \
+    SAVE_VAL(section, "Order",         source.Order); \
+    SAVE_VAL(section, "MountPoint",    source.MountPoint); \
+    SAVE_VAL(section, "FOV",           source.FOV); \
+    SAVE_VAL(section, "OffsetHeight",  source.OffsetHeight); \
+    SAVE_VAL(section, "OffsetForward", source.OffsetForward); \
+    SAVE_VAL(section, "OffsetSide",    source.OffsetSide); \
+    SAVE_VAL(section, "Pitch",         source.Pitch); \
 }
 
 #define LOAD_VAL_CAMERA(section, source) { \
-    LOAD_VAL(section, "Order",         ##source.Order); \
-    LOAD_VAL(section, "MountPoint",    ##source.MountPoint); \
-    LOAD_VAL(section, "FOV",           ##source.FOV); \
-    LOAD_VAL(section, "OffsetHeight",  ##source.OffsetHeight); \
-    LOAD_VAL(section, "OffsetForward", ##source.OffsetForward); \
-    LOAD_VAL(section, "OffsetSide",    ##source.OffsetSide); \
-    LOAD_VAL(section, "Pitch",         ##source.Pitch); \
+    LOAD_VAL(section, "Order",         source.Order); \
+    LOAD_VAL(section, "MountPoint",    source.MountPoint); \
+    LOAD_VAL(section, "FOV",           source.FOV); \
+    LOAD_VAL(section, "OffsetHeight",  source.OffsetHeight); \
+    LOAD_VAL(section, "OffsetForward", source.OffsetForward); \
+    LOAD_VAL(section, "OffsetSide",    source.OffsetSide); \
+    LOAD_VAL(section, "Pitch",         source.Pitch); \
+}
+
+namespace {
+    void parseId(CConfig& config, const std::string& modelHashStr, const std::string& modelName) {
+        if (modelHashStr.empty() && modelName.empty()) {
+            // This is a no-vehicle config. Nothing to be done.
+        }
+        else if (modelHashStr.empty()) {
+            // This config only has a model name.
+            config.ModelHash = StrUtil::Joaat(modelName.c_str());
+            config.ModelName = modelName;
+        }
+        else {
+            // This config only has a hash.
+            Hash modelHash = 0;
+            int found = sscanf_s(modelHashStr.c_str(), "%X", &modelHash);
+
+            if (found == 1) {
+                config.ModelHash = modelHash;
+
+                auto& asCache = ASCache::Get();
+                auto it = asCache.find(modelHash);
+                config.ModelName = it == asCache.end() ? std::string() : it->second;
+            }
+        }
+    }
+
+    // Minimal line scan for the [ID] section, stops as soon as the section ends.
+    // Keys and section names are matched case-insensitively, like CSimpleIniA does.
+    bool readIdSection(const std::string& configFile,
+        std::string& modelHashStr, std::string& modelName, std::string& plate) {
+        std::ifstream file(configFile);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        bool inId = false;
+        bool firstLine = true;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (firstLine && line.starts_with("\xEF\xBB\xBF")) {
+                line.erase(0, 3);
+            }
+            firstLine = false;
+
+            StrUtil::Trim(line);
+            if (line.empty() || line[0] == ';' || line[0] == '#') {
+                continue;
+            }
+
+            if (line.front() == '[') {
+                if (inId) {
+                    break;
+                }
+                auto end = line.find(']');
+                inId = end != std::string::npos &&
+                    StrUtil::Strcmpwi(StrUtil::TrimCopy(line.substr(1, end - 1)), "ID");
+                continue;
+            }
+
+            if (!inId) {
+                continue;
+            }
+
+            auto eq = line.find('=');
+            if (eq == std::string::npos) {
+                continue;
+            }
+
+            std::string key = StrUtil::ToLower(StrUtil::TrimCopy(line.substr(0, eq)));
+            std::string value = StrUtil::TrimCopy(line.substr(eq + 1));
+            if (key == "modelhash") {
+                modelHashStr = value;
+            }
+            else if (key == "modelname") {
+                modelName = value;
+            }
+            else if (key == "plate") {
+                plate = value;
+            }
+        }
+        return true;
+    }
 }
 
 CConfig CConfig::Read(const std::string& configFile) {
@@ -192,6 +278,7 @@ CConfig CConfig::Read(const std::string& configFile) {
     }
 
     config.Name = std::filesystem::path(configFile).stem().string();
+    config.mPath = configFile;
     LOG(DEBUG, "[Config] Reading {}", config.Name);
 
     // [ID]
@@ -199,28 +286,7 @@ CConfig CConfig::Read(const std::string& configFile) {
     std::string modelHashStr = ini.GetValue("ID", "ModelHash", "");
     std::string modelName = ini.GetValue("ID", "ModelName", "");
 
-    if (modelHashStr.empty() && modelName.empty()) {
-        // This is a no-vehicle config. Nothing to be done.
-    }
-    else if (modelHashStr.empty()) {
-        // This config only has a model name.
-        config.ModelHash = StrUtil::Joaat(modelName.c_str());
-        config.ModelName = modelName;
-    }
-    else {
-        // This config only has a hash.
-        Hash modelHash = 0;
-        int found = sscanf_s(modelHashStr.c_str(), "%X", &modelHash);
-
-        if (found == 1) {
-            config.ModelHash = modelHash;
-
-            auto& asCache = ASCache::Get();
-            auto it = asCache.find(modelHash);
-            std::string modelName = it == asCache.end() ? std::string() : it->second;
-            config.ModelName = modelName;
-        }
-    }
+    parseId(config, modelHashStr, modelName);
 
     config.Plate = ini.GetValue("ID", "Plate", "");
 
@@ -307,11 +373,60 @@ CConfig CConfig::Read(const std::string& configFile) {
     return config;
 }
 
-void CConfig::Write(ESaveType saveType) {
-    Write(Name, 0, std::string(), saveType);
+CConfig CConfig::ReadHeader(const std::string& configFile) {
+    std::string modelHashStr;
+    std::string modelName;
+    std::string plate;
+    if (!readIdSection(configFile, modelHashStr, modelName, plate)) {
+        return {};
+    }
+
+    CConfig config{};
+    config.Name = std::filesystem::path(configFile).stem().string();
+    config.mPath = configFile;
+    config.mLoaded = false;
+
+    parseId(config, modelHashStr, modelName);
+    config.Plate = plate;
+    return config;
 }
 
-bool CConfig::Write(const std::string& newName, Hash model, std::string plate, ESaveType saveType) {
+bool CConfig::EnsureLoaded() {
+    if (mLoaded) {
+        return true;
+    }
+
+    CConfig full = Read(mPath);
+    if (full.Name.empty()) {
+        // Stays unloaded, so it's never saved or cached over the unreadable file,
+        // and the next EnsureLoaded tries again.
+        LOG(ERROR, "[Config] Failed to load {}, using a default camera", Name);
+        if (Mount.empty()) {
+            Mount = { SCameraSettings{ .Name = "Default" } };
+            CamIndex = 0;
+        }
+        return false;
+    }
+
+    // Keep what was matched on, the file may have changed since.
+    full.Name = Name;
+    full.ModelHash = ModelHash;
+    full.ModelName = ModelName;
+    full.Plate = Plate;
+    *this = std::move(full);
+    return true;
+}
+
+bool CConfig::Write(ESaveType saveType) {
+    return Write(Name, 0, std::string(), saveType);
+}
+
+bool CConfig::Write(const std::string& newName, uint32_t model, std::string plate, ESaveType saveType) {
+    if (!mLoaded && newName == Name) {
+        LOG(ERROR, "[Config] {} was never read, not overwriting it", Name);
+        return false;
+    }
+
     const auto configsPath = Paths::GetModPath() / "Configs";
     const auto configFile = configsPath / std::format("{}.ini", newName);
 
@@ -327,6 +442,9 @@ bool CConfig::Write(const std::string& newName, Hash model, std::string plate, E
             configFile.string(), result);
     }
 
+    // Unchanged cameras are already in our own file, as long as it could be read.
+    const bool onlyDirtyMounts = result >= 0 && newName == Name;
+
     LOG(DEBUG, "[Config] Saving {}", Name);
 
     // [ID]
@@ -366,6 +484,9 @@ bool CConfig::Write(const std::string& newName, Hash model, std::string plate, E
 
     // [Mount<Name>]
     for (const auto& mount : Mount) {
+        if (onlyDirtyMounts && !mount.Dirty) {
+            continue;
+        }
         const auto& name = mount.Name;
         SAVE_VAL_CAMERA(  std::format("Mount{}", name),          mount);
         SAVE_VAL_LEAN(    std::format("Mount{}.Lean", name),     mount.Lean);
@@ -380,6 +501,13 @@ bool CConfig::Write(const std::string& newName, Hash model, std::string plate, E
         LOG(ERROR, "[Config] Failed to save {}", Name);
         return false;
     }
+    if (newName == Name) {
+        mPath = configFile.string();
+        Dirty = false;
+        for (auto& mount : Mount) {
+            mount.Dirty = false;
+        }
+    }
     LOG(DEBUG, "[Config] Saved {}", Name);
     return true;
 }
@@ -1,5 +1,5 @@
 #pragma once
-#include <inc/types.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -115,20 +115,41 @@ public:
         SHorizonLock HorizonLock;
         SMovement Movement;
         SDoF DoF;
+
+        // Set when edited, so saving only updates the sections of changed cameras.
+        bool Dirty = false;
     };
 
     CConfig() = default;
     static CConfig Read(const std::string& configFile);
 
-    void Write(ESaveType saveType);
-    bool Write(const std::string& newName, Hash model, std::string plate, ESaveType saveType);
+    // Only reads [ID], so the config can be matched against a vehicle.
+    // Does not log, so it can be used from worker threads.
+    // The rest is read through EnsureLoaded() once the config is used.
+    static CConfig ReadHeader(const std::string& configFile);
+
+    // Reads the remaining sections if only the header was read.
+    // Returns false if the file could not be read. In that case
+    // the config gets a default camera so it's still usable, but
+    // stays unloaded, so it's not written over its own file.
+    bool EnsureLoaded();
+    bool IsLoaded() const { return mLoaded; }
+    const std::string& Path() const { return mPath; }
+
+    // Both return false if nothing was written.
+    bool Write(ESaveType saveType);
+    bool Write(const std::string& newName, uint32_t model, std::string plate, ESaveType saveType);
 
     void DeleteCamera(const std::string& camToDelete);
 
     std::string Name;
 
+    // Set when edited through the menu, cleared when written.
+    // SaveConfigs only writes dirty configs.
+    bool Dirty = false;
+
     // ID
-    Hash ModelHash = 0;
+    uint32_t ModelHash = 0;
     std::string ModelName;
     std::string Plate;
 
@@ -136,14 +157,24 @@ public:
     bool Enable = true;
     int CamIndex = 0;
 
-    // Look
-    struct {
+    struct SLook {
         float LookTime = 0.000010f;
         float MouseLookTime = 0.000001f;
         int MouseCenterTimeout = 750;
         float MouseSensitivity = 0.3f;
-    } Look;
+    };
+
+    // Look
+    SLook Look;
 
     // [Mount0-9]
     std::vector<SCameraSettings> Mount;
+
+private:
+    friend class CConfigCache;
+
+    std::string mPath;
+    // Configs created in code are complete. ReadHeader leaves this false,
+    // and so does a failed EnsureLoaded.
+    bool mLoaded = true;
 };
@@ -0,0 +1,404 @@
+#include "ConfigCache.hpp"
+
+#include "Util/Logger.hpp"
+#include "Util/Strings.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+    // Bump when CConfig or any of its members change.
+    constexpr uint32_t cacheVersion = 2;
+    constexpr char cacheMagic[4] = { 'F', 'P', 'V', 'C' };
+
+    // Where a string is in the string table
+    struct SStringRef {
+        uint32_t Offset;
+        uint32_t Size;
+    };
+
+    struct SEntryRecord {
+        SStringRef Path;
+        SStringRef Name;
+        SStringRef ModelName;
+        SStringRef Plate;
+        int64_t WriteTime;
+        uint64_t FileSize;
+        uint32_t ModelHash;
+        // Camera records, only for loaded configs
+        uint32_t FirstMount;
+        uint32_t MountCount;
+        int32_t CamIndex;
+        CConfig::SLook Look;
+        uint8_t Loaded;
+        uint8_t Enable;
+    };
+
+    struct SMountRecord {
+        SStringRef Name;
+        int32_t Order;
+        CConfig::EMountPoint MountPoint;
+        float FOV;
+        float OffsetHeight;
+        float OffsetForward;
+        float OffsetSide;
+        float Pitch;
+        CConfig::SLean Lean;
+        CConfig::SHorizonLock HorizonLock;
+        CConfig::SMovement Movement;
+        CConfig::SDoF DoF;
+    };
+
+    static_assert(std::is_trivially_copyable_v<SEntryRecord>);
+    static_assert(std::is_trivially_copyable_v<SMountRecord>);
+
+    // The file is the header, the entry records, the mount records and the
+    // string table, in that order. The plain structs are copied as-is, so their
+    // sizes are part of the header. A layout change that's not caught by the
+    // version still invalidates the cache.
+    struct SHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t EntryRecordSize;
+        uint32_t MountRecordSize;
+        uint32_t LeanSize;
+        uint32_t MovementSize;
+        uint32_t HorizonLockSize;
+        uint32_t DoFSize;
+        uint32_t LookSize;
+        uint32_t EntryCount;
+        uint32_t MountCount;
+        uint32_t StringsSize;
+    };
+
+    SHeader makeHeader(uint32_t entryCount, uint32_t mountCount, uint32_t stringsSize) {
+        SHeader header{
+            .Magic = {},
+            .Version = cacheVersion,
+            .EntryRecordSize = sizeof(SEntryRecord),
+            .MountRecordSize = sizeof(SMountRecord),
+            .LeanSize = sizeof(CConfig::SLean),
+            .MovementSize = sizeof(CConfig::SMovement),
+            .HorizonLockSize = sizeof(CConfig::SHorizonLock),
+            .DoFSize = sizeof(CConfig::SDoF),
+            .LookSize = sizeof(CConfig::SLook),
+            .EntryCount = entryCount,
+            .MountCount = mountCount,
+            .StringsSize = stringsSize,
+        };
+        std::memcpy(header.Magic, cacheMagic, sizeof(cacheMagic));
+        return header;
+    }
+
+    bool sameLayout(const SHeader& header) {
+        const SHeader expected = makeHeader(0, 0, 0);
+        return std::memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) == 0 &&
+            header.Version == expected.Version &&
+            header.EntryRecordSize == expected.EntryRecordSize &&
+            header.MountRecordSize == expected.MountRecordSize &&
+            header.LeanSize == expected.LeanSize &&
+            header.MovementSize == expected.MovementSize &&
+            header.HorizonLockSize == expected.HorizonLockSize &&
+            header.DoFSize == expected.DoFSize &&
+            header.LookSize == expected.LookSize;
+    }
+
+    uint64_t fileSize(const SHeader& header) {
+        return sizeof(SHeader) +
+            static_cast<uint64_t>(header.EntryCount) * sizeof(SEntryRecord) +
+            static_cast<uint64_t>(header.MountCount) * sizeof(SMountRecord) +
+            header.StringsSize;
+    }
+
+    // Reads records out of a mapped cache with a valid header and size.
+    // Records are copied out, the view has no alignment guarantees past the header.
+    class CLayout {
+    public:
+        explicit CLayout(const char* data)
+            : mData(data) {
+            std::memcpy(&mHeader, data, sizeof(mHeader));
+        }
+
+        const SHeader& Header() const { return mHeader; }
+
+        SEntryRecord Entry(uint32_t index) const {
+            return read<SEntryRecord>(sizeof(SHeader) + static_cast<size_t>(index) * sizeof(SEntryRecord));
+        }
+
+        SMountRecord Mount(uint32_t index) const {
+            return read<SMountRecord>(mountsOffset() + static_cast<size_t>(index) * sizeof(SMountRecord));
+        }
+
+        bool Valid(SStringRef ref) const {
+            return static_cast<uint64_t>(ref.Offset) + ref.Size <= mHeader.StringsSize;
+        }
+
+        std::string String(SStringRef ref) const {
+            return std::string(mData + stringsOffset() + ref.Offset, ref.Size);
+        }
+
+    private:
+        template <typename T>
+        T read(size_t offset) const {
+            T value;
+            std::memcpy(&value, mData + offset, sizeof(T));
+            return value;
+        }
+
+        size_t mountsOffset() const {
+            return sizeof(SHeader) + static_cast<size_t>(mHeader.EntryCount) * sizeof(SEntryRecord);
+        }
+
+        size_t stringsOffset() const {
+            return mountsOffset() + static_cast<size_t>(mHeader.MountCount) * sizeof(SMountRecord);
+        }
+
+        const char* mData;
+        SHeader mHeader;
+    };
+
+    // Every reference is checked once here, so Find() can trust the records.
+    bool validEntry(const CLayout& layout, const SEntryRecord& record) {
+        if (!layout.Valid(record.Path) || !layout.Valid(record.Name) ||
+            !layout.Valid(record.ModelName) || !layout.Valid(record.Plate)) {
+            return false;
+        }
+        if (!record.Loaded) {
+            return true;
+        }
+        if (record.MountCount == 0 || record.CamIndex < 0 ||
+            static_cast<uint32_t>(record.CamIndex) >= record.MountCount ||
+            static_cast<uint64_t>(record.FirstMount) + record.MountCount > layout.Header().MountCount) {
+            return false;
+        }
+        for (uint32_t m = 0; m < record.MountCount; ++m) {
+            if (!layout.Valid(layout.Mount(record.FirstMount + m).Name)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool writeAll(std::ofstream& file, const std::vector<T>& values) {
+        return static_cast<bool>(file.write(reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T))));
+    }
+}
+
+CConfigCache::CConfigCache(std::filesystem::path cacheFile)
+    : mCacheFile(std::move(cacheFile)) {}
+
+bool CConfigCache::Load() {
+    Clear();
+
+    std::error_code ec;
+    if (!std::filesystem::exists(mCacheFile, ec)) {
+        LOG(DEBUG, "[Cache] No config cache found");
+        return false;
+    }
+
+    if (!mFile.Open(mCacheFile)) {
+        LOG(WARN, "[Cache] Failed to map {}", mCacheFile.string());
+        return false;
+    }
+
+    SHeader header{};
+    if (mFile.Size() < sizeof(SHeader)) {
+        LOG(WARN, "[Cache] Config cache is corrupt, ignoring it");
+        Clear();
+        return false;
+    }
+    std::memcpy(&header, mFile.Data(), sizeof(header));
+
+    if (!sameLayout(header)) {
+        LOG(INFO, "[Cache] Config cache is outdated, ignoring it");
+        Clear();
+        return false;
+    }
+
+    if (fileSize(header) != mFile.Size()) {
+        LOG(WARN, "[Cache] Config cache has the wrong size, ignoring it");
+        Clear();
+        return false;
+    }
+
+    const CLayout layout(mFile.Data());
+    for (uint32_t i = 0; i < header.EntryCount; ++i) {
+        const SEntryRecord record = layout.Entry(i);
+        if (!validEntry(layout, record)) {
+            LOG(WARN, "[Cache] Config cache is corrupt, ignoring it");
+            Clear();
+            return false;
+        }
+
+        SEntry entry{
+            .File = { layout.String(record.Path), record.WriteTime, record.FileSize },
+            .Loaded = record.Loaded != 0,
+            .Record = i,
+        };
+        std::string key = StrUtil::ToLower(entry.File.Path);
+        mEntries.emplace(std::move(key), std::move(entry));
+    }
+
+    LOG(DEBUG, "[Cache] Mapped {} cached configs", mEntries.size());
+    return true;
+}
+
+bool CConfigCache::Save(const std::vector<SSource>& sources) {
+    std::vector<SEntryRecord> entries;
+    std::vector<SMountRecord> mounts;
+    std::string strings;
+    entries.reserve(sources.size());
+
+    auto addString = [&strings](const std::string& value) {
+        SStringRef ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+        strings.append(value);
+        return ref;
+    };
+
+    for (const auto& source : sources) {
+        const CConfig& config = *source.Config;
+        SEntryRecord& record = entries.emplace_back();
+        record.Path = addString(source.File.Path);
+        record.Name = addString(config.Name);
+        record.ModelName = addString(config.ModelName);
+        record.Plate = addString(config.Plate);
+        record.WriteTime = source.File.WriteTime;
+        record.FileSize = source.File.Size;
+        record.ModelHash = config.ModelHash;
+        record.Loaded = config.IsLoaded();
+
+        if (!config.IsLoaded()) {
+            continue;
+        }
+
+        record.Enable = config.Enable;
+        record.CamIndex = config.CamIndex;
+        record.Look = config.Look;
+        record.FirstMount = static_cast<uint32_t>(mounts.size());
+        record.MountCount = static_cast<uint32_t>(config.Mount.size());
+        for (const auto& mount : config.Mount) {
+            SMountRecord& mountRecord = mounts.emplace_back();
+            mountRecord.Name = addString(mount.Name);
+            mountRecord.Order = mount.Order;
+            mountRecord.MountPoint = mount.MountPoint;
+            mountRecord.FOV = mount.FOV;
+            mountRecord.OffsetHeight = mount.OffsetHeight;
+            mountRecord.OffsetForward = mount.OffsetForward;
+            mountRecord.OffsetSide = mount.OffsetSide;
+            mountRecord.Pitch = mount.Pitch;
+            mountRecord.Lean = mount.Lean;
+            mountRecord.HorizonLock = mount.HorizonLock;
+            mountRecord.Movement = mount.Movement;
+            mountRecord.DoF = mount.DoF;
+        }
+    }
+
+    const SHeader header = makeHeader(static_cast<uint32_t>(entries.size()),
+        static_cast<uint32_t>(mounts.size()), static_cast<uint32_t>(strings.size()));
+
+    // Write next to it first, so a failed write can't leave a half cache behind.
+    auto tempFile = mCacheFile;
+    tempFile += ".tmp";
+    {
+        std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() ||
+            !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !writeAll(file, entries) ||
+            !writeAll(file, mounts) ||
+            !file.write(strings.data(), static_cast<std::streamsize>(strings.size()))) {
+            LOG(WARN, "[Cache] Failed to write {}", tempFile.string());
+            return false;
+        }
+    }
+
+    // A mapped file can't be replaced.
+    Clear();
+
+    std::error_code ec;
+    std::filesystem::rename(tempFile, mCacheFile, ec);
+    if (ec) {
+        LOG(WARN, "[Cache] Failed to replace {}: {}", mCacheFile.string(), ec.message());
+        std::filesystem::remove(tempFile, ec);
+        Load();
+        return false;
+    }
+
+    LOG(DEBUG, "[Cache] Wrote {} configs ({} bytes)", sources.size(), fileSize(header));
+    return Load();
+}
+
+void CConfigCache::Clear() {
+    mEntries.clear();
+    mFile.Close();
+}
+
+const CConfigCache::SEntry* CConfigCache::findEntry(const SFileInfo& file) const {
+    auto it = mEntries.find(StrUtil::ToLower(file.Path));
+    if (it == mEntries.end() ||
+        it->second.File.WriteTime != file.WriteTime ||
+        it->second.File.Size != file.Size) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool CConfigCache::Find(const SFileInfo& file, CConfig& config) const {
+    const SEntry* entry = findEntry(file);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    const CLayout layout(mFile.Data());
+    const SEntryRecord record = layout.Entry(entry->Record);
+
+    config = CConfig();
+    config.Name = layout.String(record.Name);
+    config.ModelHash = record.ModelHash;
+    config.ModelName = layout.String(record.ModelName);
+    config.Plate = layout.String(record.Plate);
+    config.mPath = entry->File.Path;
+    config.mLoaded = entry->Loaded;
+
+    if (!entry->Loaded) {
+        return true;
+    }
+
+    config.Enable = record.Enable != 0;
+    config.CamIndex = record.CamIndex;
+    config.Look = record.Look;
+    config.Mount.reserve(record.MountCount);
+    for (uint32_t m = 0; m < record.MountCount; ++m) {
+        const SMountRecord mountRecord = layout.Mount(record.FirstMount + m);
+        auto& mount = config.Mount.emplace_back();
+        mount.Name = layout.String(mountRecord.Name);
+        mount.Order = mountRecord.Order;
+        mount.MountPoint = mountRecord.MountPoint;
+        mount.FOV = mountRecord.FOV;
+        mount.OffsetHeight = mountRecord.OffsetHeight;
+        mount.OffsetForward = mountRecord.OffsetForward;
+        mount.OffsetSide = mountRecord.OffsetSide;
+        mount.Pitch = mountRecord.Pitch;
+        mount.Lean = mountRecord.Lean;
+        mount.HorizonLock = mountRecord.HorizonLock;
+        mount.Movement = mountRecord.Movement;
+        mount.DoF = mountRecord.DoF;
+    }
+    return true;
+}
+
+bool CConfigCache::Matches(const std::vector<SSource>& sources) const {
+    if (sources.size() != mEntries.size()) {
+        return false;
+    }
+
+    for (const auto& source : sources) {
+        const SEntry* cached = findEntry(source.File);
+        if (cached == nullptr || cached->Loaded != source.Config->IsLoaded()) {
+            return false;
+        }
+    }
+    return true;
+}
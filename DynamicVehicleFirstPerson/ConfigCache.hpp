@@ -0,0 +1,59 @@
+#pragma once
+#include "Config.hpp"
+#include "Util/MappedFile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Binary copy of the parsed configs, stored next to them in Configs/.cache.
+// An entry is only used while the write time and size of its .ini file
+// still match, so editing a config by hand always falls back to the .ini.
+// Configs that were only partially read are stored as such.
+// The file is fixed-size records and a string table, read through a mapped
+// view. A config is only built from its records when it's found.
+class CConfigCache {
+public:
+    struct SFileInfo {
+        std::string Path;
+        int64_t WriteTime = 0;
+        uint64_t Size = 0;
+
+        bool operator==(const SFileInfo&) const = default;
+    };
+
+    struct SSource {
+        SFileInfo File;
+        const CConfig* Config;
+    };
+
+    explicit CConfigCache(std::filesystem::path cacheFile);
+
+    // Returns false if the cache doesn't exist, is from another version or is corrupt.
+    bool Load();
+    bool Save(const std::vector<SSource>& sources);
+    void Clear();
+
+    // Returns false if there is no entry or the file has changed since.
+    bool Find(const SFileInfo& file, CConfig& config) const;
+
+    // True if the cache holds exactly these files, in the same load state.
+    bool Matches(const std::vector<SSource>& sources) const;
+
+private:
+    struct SEntry {
+        SFileInfo File;
+        bool Loaded = false;
+        // Index of its record in the mapped file
+        uint32_t Record = 0;
+    };
+
+    const SEntry* findEntry(const SFileInfo& file) const;
+
+    std::filesystem::path mCacheFile;
+    CMappedFile mFile;
+    // Keyed by lowercase path
+    std::unordered_map<std::string, SEntry> mEntries;
+};
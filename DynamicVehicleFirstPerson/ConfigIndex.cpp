@@ -0,0 +1,79 @@
+#include "ConfigIndex.hpp"
+
+#include "Util/Logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+void CConfigIndex::Build(std::list<CConfig>& configs) {
+    Clear();
+    mModelConfigs.reserve(configs.size());
+    mPlateConfigs.reserve(configs.size());
+
+    // emplace keeps the first entry, same as the old first-match search.
+    for (auto& config : configs) {
+        if (config.ModelHash == 0) {
+            continue;
+        }
+
+        if (config.Plate.empty()) {
+            mModelConfigs.emplace(config.ModelHash, &config);
+            continue;
+        }
+
+        uint64_t plateKey = 0;
+        if (!NormalizePlate(config.Plate, plateKey)) {
+            const bool blank = std::all_of(config.Plate.begin(), config.Plate.end(),
+                [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; });
+            if (blank) {
+                LOG(WARN, "[Config] {}: Plate is blank and can never match", config.Name);
+            }
+            else {
+                LOG(WARN, "[Config] {}: Plate '{}' is longer than 8 characters and can never match",
+                    config.Name, config.Plate);
+            }
+            continue;
+        }
+        mPlateConfigs.emplace(SPlateKey{ config.ModelHash, plateKey }, &config);
+    }
+}
+
+void CConfigIndex::Clear() {
+    mModelConfigs.clear();
+    mPlateConfigs.clear();
+}
+
+CConfig* CConfigIndex::Find(Hash model, std::string_view plate) const {
+    uint64_t plateKey = 0;
+    if (NormalizePlate(plate, plateKey)) {
+        auto plateConfig = mPlateConfigs.find(SPlateKey{ model, plateKey });
+        if (plateConfig != mPlateConfigs.end()) {
+            return plateConfig->second;
+        }
+    }
+
+    auto modelConfig = mModelConfigs.find(model);
+    if (modelConfig != mModelConfigs.end()) {
+        return modelConfig->second;
+    }
+    return nullptr;
+}
+
+bool CConfigIndex::NormalizePlate(std::string_view plate, uint64_t& key) {
+    auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+
+    while (!plate.empty() && isSpace(plate.front()))
+        plate.remove_prefix(1);
+    while (!plate.empty() && isSpace(plate.back()))
+        plate.remove_suffix(1);
+
+    if (plate.empty() || plate.size() > sizeof(key))
+        return false;
+
+    key = 0;
+    for (size_t i = 0; i < plate.size(); ++i) {
+        auto c = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(plate[i])));
+        key |= static_cast<uint64_t>(c) << (8 * i);
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Config.hpp"
+
+#include <inc/types.h>
+#include <cstdint>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Lookup table from vehicle model (and plate) to config.
+// Built once when configs are (re)loaded, so picking the active config
+// doesn't depend on how many configs there are.
+class CConfigIndex {
+public:
+    void Build(std::list<CConfig>& configs);
+    void Clear();
+
+    // Model and plate match first, then model-only match.
+    // Returns nullptr if neither exists.
+    CConfig* Find(Hash model, std::string_view plate) const;
+
+    // Plates are compared trimmed and case-insensitive. The game limits
+    // plates to 8 characters, so a normalized plate fits in a uint64_t.
+    // Returns false if the plate is empty or doesn't fit.
+    static bool NormalizePlate(std::string_view plate, uint64_t& key);
+
+private:
+    struct SPlateKey {
+        Hash Model;
+        uint64_t Plate;
+
+        bool operator==(const SPlateKey&) const = default;
+    };
+
+    struct SPlateKeyHash {
+        size_t operator()(const SPlateKey& key) const {
+            return std::hash<uint64_t>()(key.Plate ^ (static_cast<uint64_t>(key.Model) * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    std::unordered_map<Hash, CConfig*> mModelConfigs;
+    std::unordered_map<SPlateKey, CConfig*, SPlateKeyHash> mPlateConfigs;
+};
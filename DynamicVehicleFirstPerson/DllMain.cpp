@@ -90,6 +90,7 @@ BOOL APIENTRY DllMain(HMODULE hInstance, DWORD reason, LPVOID lpReserved) {
             initializePaths(hInstance);
             LOG(INFO, "{} {} (built {} {})", Constants::ScriptName, Constants::DisplayVersion, __DATE__, __TIME__);
             LOG(INFO, "Data path: {}", Paths::GetModPath().string());
+            g_Logger.Start();
 
             scriptRegister(hInstance, FPV::ScriptMain);
             LOG(INFO, "Script registered");
@@ -97,6 +98,8 @@ BOOL APIENTRY DllMain(HMODULE hInstance, DWORD reason, LPVOID lpReserved) {
         }
         case DLL_PROCESS_DETACH: {
             scriptUnregister(hInstance);
+            // lpReserved is non-null when the process is terminating.
+            g_Logger.Shutdown(lpReserved != nullptr);
             break;
         }
         default: {
@@ -7,10 +7,13 @@
 #include "Util/Logger.hpp"
 #include "Util/Paths.hpp"
 #include "Util/ScriptUtils.hpp"
+#include "Util/Tracing.hpp"
 #include "Util/UI.hpp"
 
 #include <inc/natives.h>
 #include <algorithm>
+#include <chrono>
+#include <format>
 
 using std::to_underlying;
 
@@ -75,11 +78,13 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 auto onRight = [&]() {
                     if (cfg->CamIndex < cfg->Mount.size() - 1) {
                         ++cfg->CamIndex;
+                        cfg->Dirty = true;
                     }
                 };
                 auto onLeft = [&]() {
                     if (cfg->CamIndex > 0) {
                         --cfg->CamIndex;
+                        cfg->Dirty = true;
                     }
                 };
 
@@ -112,9 +117,11 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
 
             Vehicle vehicle = context.GetVehicle();
             if (config != nullptr) {
-                mbCtx.BoolOption("Enable current config", config->Enable,
+                if (mbCtx.BoolOption("Enable current config", config->Enable,
                     { std::format("Enable or disable the current config ({}).", config->Name),
-                      "Useful if no custom FPV is desired in certain vehicles." });
+                      "Useful if no custom FPV is desired in certain vehicles." })) {
+                    config->Dirty = true;
+                }
             }
             if (!Util::VehicleAvailable(vehicle, PLAYER::PLAYER_PED_ID())) {
                 mbCtx.Option("~c~Create config...",
@@ -152,6 +159,7 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
 
                 if (triggered) {
                     CConfig newConfig = config;
+                    newConfig.EnsureLoaded();
                     CreateConfig(newConfig, vehicle);
                 }
             }
@@ -175,29 +183,32 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SCameraSettings& cam = config->Mount[config->CamIndex];
 
+            bool changed = false;
+
             int mountInt = to_underlying(cam.MountPoint);
             if (mbCtx.StringArray("Attach to", mountPointNames, mountInt,
                 { "Mounting to the vehicle is pretty static and predictable.",
                   "Mounting to the driver transmit all their animations." })) {
+                changed = true;
                 cam.MountPoint = static_cast<CConfig::EMountPoint>(mountInt);
 
                 // it'll re-acquire next tick with the correct position.
                 context.Cancel();
             }
 
-            mbCtx.FloatOptionCb("Field of view", cam.FOV, 1.0f, 120.0f, 0.5f, FPV::GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Field of view", cam.FOV, 1.0f, 120.0f, 0.5f, FPV::GetKbEntryFloat,
                 { "In degrees." });
 
-            mbCtx.FloatOptionCb("Height offset", cam.OffsetHeight, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Height offset", cam.OffsetHeight, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
                 { "Distance in meters." });
 
-            mbCtx.FloatOptionCb("Forward offset", cam.OffsetForward, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Forward offset", cam.OffsetForward, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
                 { "Distance in meters." });
 
-            mbCtx.FloatOptionCb("Side offset", cam.OffsetSide, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Side offset", cam.OffsetSide, -2.0f, 2.0f, 0.01f, FPV::GetKbEntryFloat,
                 { "Distance in meters." });
 
-            mbCtx.FloatOptionCb("Pitch offset", cam.Pitch, -20.0f, 20.0f, 0.1f, FPV::GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch offset", cam.Pitch, -20.0f, 20.0f, 0.1f, FPV::GetKbEntryFloat,
                 { "In degrees." });
 
             mbCtx.MenuOption("Leaning options", "lean.menu",
@@ -211,6 +222,11 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
 
             mbCtx.MenuOption("Depth of field options", "dof.menu",
                 { "Modify depth of field effects." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("sensitivity.menu",
@@ -223,16 +239,22 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 return;
             }
 
-            mbCtx.FloatOptionCb("Controller smoothing", config->Look.LookTime, 0.0f, 0.5f, 0.000001f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Controller smoothing", config->Look.LookTime, 0.0f, 0.5f, 0.000001f, GetKbEntryFloat,
                 { "How smooth the camera moves.", "Press enter to enter a value manually. Range: 0.0 to 0.5." });
 
-            mbCtx.FloatOptionCb("Mouse sensitivity", config->Look.MouseSensitivity, 0.05f, 2.0f, 0.05f, GetKbEntryFloat);
+            changed |= mbCtx.FloatOptionCb("Mouse sensitivity", config->Look.MouseSensitivity, 0.05f, 2.0f, 0.05f, GetKbEntryFloat);
 
-            mbCtx.FloatOptionCb("Mouse smoothing", config->Look.MouseLookTime, 0.0f, 0.5f, 0.000001f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Mouse smoothing", config->Look.MouseLookTime, 0.0f, 0.5f, 0.000001f, GetKbEntryFloat,
                 { "How smooth the camera moves.", "Press enter to enter a value manually. Range: 0.0 to 0.5." });
 
-            mbCtx.IntOptionCb("Mouse center timeout", config->Look.MouseCenterTimeout, 0, 120000, 500, FPV::GetKbEntryInt,
+            changed |= mbCtx.IntOptionCb("Mouse center timeout", config->Look.MouseCenterTimeout, 0, 120000, 500, FPV::GetKbEntryInt,
                 { "Milliseconds before centering the camera after looking with the mouse." });
+
+            if (changed) {
+                config->Dirty = true;
+            }
         });
 
     submenus.emplace_back("lean.menu",
@@ -244,14 +266,21 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SCameraSettings& cam = config->Mount[config->CamIndex];
 
-            mbCtx.FloatOptionCb("Center distance", cam.Lean.CenterDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Center distance", cam.Lean.CenterDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "Distance in meters to lean over to the center when looking back." });
 
-            mbCtx.FloatOptionCb("Forward distance", cam.Lean.ForwardDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Forward distance", cam.Lean.ForwardDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "Distance in meters to lean forward when looking back/sideways." });
 
-            mbCtx.FloatOptionCb("Up distance", cam.Lean.UpDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Up distance", cam.Lean.UpDist, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "Distance in meters to peek up when looking back." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("inertia.menu",
@@ -263,9 +292,12 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SMovement& movement = config->Mount[config->CamIndex].Movement;
 
+            bool changed = false;
+
             if (mbCtx.BoolOption("Enable inertia & movement", movement.Follow,
                 { "Enable to allow the camera to rotate and move around in response to physics.",
                   "When disabled, camera is rigidly mounted to vehicle or driver." })) {
+                changed = true;
                 context.Cancel();
             }
 
@@ -285,7 +317,7 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 { "Options for how vertical acceleration affects the camera.",
                   "Affects camera up/down movement." });
 
-            mbCtx.FloatOptionCb("Movement roughness", movement.Roughness, -2.90f, 10.0f, 0.10f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Movement roughness", movement.Roughness, -2.90f, 10.0f, 0.10f, GetKbEntryFloat,
                 { "How rough the camera movement is, from inertia effects.",
                   "Larger values increase roughness, causing smaller bumps to be more noticeable.",
                   "Smaller values increase smoothness, but may cause the movement to be less responsive." });
@@ -297,6 +329,7 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                     "80% of the top speed.",
                   "Set to precisely 0.0 to disable.",
                   "Recommended value for 'On' is 5.0." })) {
+                changed = true;
                 movement.ShakeSpeed = shakeSpeed / 1000.0f;
             }
 
@@ -305,8 +338,14 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 { "How much the camera should shake from rough terrain types.",
                   "Set to precisely 0.0 to disable.",
                   "Recommended value for 'On' is 7.0." })) {
+                changed = true;
                 movement.ShakeTerrain = shakeTerrain / 1000.0f;
             }
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("inertia.rot.menu",
@@ -318,14 +357,21 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SMovement& movement = config->Mount[config->CamIndex].Movement;
 
-            mbCtx.FloatOptionCb("Direction multiplier", movement.RotationDirectionMult, 0.0f, 4.0f, 0.01f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Direction multiplier", movement.RotationDirectionMult, 0.0f, 4.0f, 0.01f, GetKbEntryFloat,
                 { "How much the direction of travel affects the camera." });
 
-            mbCtx.FloatOptionCb("Rotation multiplier", movement.RotationRotationMult, 0.0f, 4.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Rotation multiplier", movement.RotationRotationMult, 0.0f, 4.0f, 0.01f, GetKbEntryFloat,
                 { "How much the rotation speed affects the camera." });
 
-            mbCtx.FloatOptionCb("Max angle", movement.RotationMaxAngle, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Max angle", movement.RotationMaxAngle, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
                 { "To how many degrees camera movement is capped." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("inertia.long.menu",
@@ -337,51 +383,58 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SMovement& movement = config->Mount[config->CamIndex].Movement;
 
-            mbCtx.FloatOptionCb("Minimum force", movement.LongDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Minimum force", movement.LongDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How hard the car should accelerate or decelerate for the camera to start moving.",
                   "Unit in Gs." });
 
-            mbCtx.FloatOptionCb("Forward scale", movement.LongForwardMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Forward scale", movement.LongForwardMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera moves forwards when decelerating.",
                   "A scale of 1.0 makes the camera move 1 meter at 1G deceleration.",
                   "A scale of 0.1 makes the camera move 10 centimeters at 1G deceleration.",
                   "0.0 disables forward movement." });
 
-            mbCtx.FloatOptionCb("Backward scale", movement.LongBackwardMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Backward scale", movement.LongBackwardMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera moves backwards when accelerating.",
                   "A scale of 1.0 makes the camera move 1 meter at 1G acceleration.",
                   "A scale of 0.1 makes the camera move 10 centimeters at 1G acceleration.",
                   "0.0 disables backward movement." });
 
-            mbCtx.FloatOptionCb("Forward limit", movement.LongForwardLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Forward limit", movement.LongForwardLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera may move forwards during deceleration.",
                   "Unit in meter." });
 
-            mbCtx.FloatOptionCb("Backward limit", movement.LongBackwardLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Backward limit", movement.LongBackwardLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera may move backwards during acceleration.",
                   "Unit in meter." });
 
-            mbCtx.FloatOptionCb("Pitch: Minimum force", movement.PitchDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch: Minimum force", movement.PitchDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the car should accelerate or decelerate for the camera to start moving.",
                   "Unit in Gs." });
 
-            mbCtx.FloatOptionCb("Pitch: Up scale", movement.PitchUpMult, 0.0f, 90.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch: Up scale", movement.PitchUpMult, 0.0f, 90.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera pitches up during acceleration.",
                   "A scale of 5.0 makes the camera pitch up 5 degrees at 1G acceleration.",
                   "0.0 disables pitch-up on acceleration." });
 
-            mbCtx.FloatOptionCb("Pitch: Down scale", movement.PitchDownMult, 0.0f, 90.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch: Down scale", movement.PitchDownMult, 0.0f, 90.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera pitches down during deceleration.",
                   "A scale of 5.0 makes the camera pitch down 5 degrees at 1G deceleration.",
                   "0.0 disables pitch-down on deceleration." });
 
-            mbCtx.FloatOptionCb("Pitch: Up limit", movement.PitchUpMaxAngle, 0.0f, 90.0f, 0.5f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch: Up limit", movement.PitchUpMaxAngle, 0.0f, 90.0f, 0.5f, GetKbEntryFloat,
                 { "How much the camera may pitch up during acceleration.",
                   "Unit in degrees." });
 
-            mbCtx.FloatOptionCb("Pitch: Down limit", movement.PitchDownMaxAngle, 0.0f, 90.0f, 0.5f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch: Down limit", movement.PitchDownMaxAngle, 0.0f, 90.0f, 0.5f, GetKbEntryFloat,
                 { "How much the camera may pitch down during deceleration.",
                   "Unit in degrees." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("inertia.lat.menu",
@@ -393,20 +446,27 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SMovement& movement = config->Mount[config->CamIndex].Movement;
 
-            mbCtx.FloatOptionCb("Minimum force", movement.LatDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Minimum force", movement.LatDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How hard the car should turn or accelerate sideways for the camera to start moving.",
                   "Unit in Gs." });
 
-            mbCtx.FloatOptionCb("Scale", movement.LatMult, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Scale", movement.LatMult, -2.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera moves left or right.",
                   "A scale of 1.0 makes the camera move 1 meter at 1G.",
                   "A scale of 0.1 makes the camera move 10 centimeters at 1G.",
                   "Negative values make the camera move \"against\" the force.",
                   "0.0 disables lateral movement." });
 
-            mbCtx.FloatOptionCb("Limit", movement.LatLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Limit", movement.LatLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera may move left or right.",
                   "Unit in meter." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("inertia.vert.menu",
@@ -418,29 +478,36 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SMovement& movement = config->Mount[config->CamIndex].Movement;
 
-            mbCtx.FloatOptionCb("Minimum force", movement.VertDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            bool changed = false;
+
+            changed |= mbCtx.FloatOptionCb("Minimum force", movement.VertDeadzone, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How hard the car goes up or down for the camera to start moving.",
                   "Unit in Gs." });
 
-            mbCtx.FloatOptionCb("Up scale", movement.VertUpMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Up scale", movement.VertUpMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera moves up when falling.",
                   "A scale of 1.0 makes the camera move 1 meter at 1G.",
                   "A scale of 0.1 makes the camera move 10 centimeters at 1G.",
                   "0.0 disables up movement." });
 
-            mbCtx.FloatOptionCb("Down scale", movement.VertDownMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Down scale", movement.VertDownMult, 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera moves down when \"pushed down\".",
                   "A scale of 1.0 makes the camera move 1 meter at 1G.",
                   "A scale of 0.1 makes the camera move 10 centimeters at 1G.",
                   "0.0 disables down movement." });
 
-            mbCtx.FloatOptionCb("Up limit", movement.VertUpLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Up limit", movement.VertUpLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera may move up.",
                   "Unit in meter." });
 
-            mbCtx.FloatOptionCb("Down limit", movement.VertDownLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Down limit", movement.VertDownLimit, 0.0f, 1.0f, 0.01f, GetKbEntryFloat,
                 { "How much the camera may move down.",
                   "Unit in meter." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("horizon.menu",
@@ -452,22 +519,29 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SHorizonLock& horLck = config->Mount[config->CamIndex].HorizonLock;
 
-            mbCtx.BoolOption("Lock to horizon", horLck.Lock,
+            bool changed = false;
+
+            changed |= mbCtx.BoolOption("Lock to horizon", horLck.Lock,
                 { "Lock the pitch and roll to the horizon." });
 
-            mbCtx.FloatOptionCb("Pitch limit", horLck.PitchLim, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch limit", horLck.PitchLim, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
                 { "How much the pitch may differ between the camera and vehicle." });
 
-            mbCtx.FloatOptionCb("Roll limit", horLck.RollLim, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Roll limit", horLck.RollLim, 0.0f, 90.0f, 1.0f, GetKbEntryFloat,
                 { "How much the roll may differ between the camera and vehicle." });
 
-            mbCtx.StringArray("Lock pitch to", PitchModeNames, horLck.PitchMode,
+            changed |= mbCtx.StringArray("Lock pitch to", PitchModeNames, horLck.PitchMode,
                 { "Lock pitch with horizon, car or center on vehicle dynamically." });
 
-            mbCtx.FloatOptionCb("Pitch center speed", horLck.CenterSpeed, 0.1f, 10.0f, 0.1f, GetKbEntryFloat,
+            changed |= mbCtx.FloatOptionCb("Pitch center speed", horLck.CenterSpeed, 0.1f, 10.0f, 0.1f, GetKbEntryFloat,
                 { "How quickly the camera centers on the vehicle pitch.",
                     "Low value: Slowly centers onto the vehicle.",
                     "High value: Quickly centers onto the vehicle." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("dof.menu",
@@ -479,7 +553,9 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             }
             CConfig::SDoF& dof = config->Mount[config->CamIndex].DoF;
 
-            mbCtx.BoolOption("Enable", dof.Enable,
+            bool changed = false;
+
+            changed |= mbCtx.BoolOption("Enable", dof.Enable,
                 { "Enable or disable dynamic depth of field.",
                   "Unfocuses the car and very far distances at high speed, for extra sense of speed.",
                   "Very High post-processing required! May have significant performance impact.",
@@ -509,92 +585,97 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 estTopSpeedTxt = "No vehicle, top speed estimation unavailable.";
             }
 
-            mbCtx.FloatOptionCb("TargetSpeedMinDoF", dof.TargetSpeedMinDoF,
+            changed |= mbCtx.FloatOptionCb("TargetSpeedMinDoF", dof.TargetSpeedMinDoF,
                 0.0f, 2.0f, 0.01f, GetKbEntryFloat,
                 { "Speed at which defocusing starts, relative to the vehicles' estimated top speed.",
                   estTopSpeedTxt,
                   targetSpeedMinTxt });
 
-            mbCtx.FloatOptionCb("TargetSpeedMaxDoF", dof.TargetSpeedMaxDoF,
+            changed |= mbCtx.FloatOptionCb("TargetSpeedMaxDoF", dof.TargetSpeedMaxDoF,
                 0.0f, 4.0f, 0.01f, GetKbEntryFloat,
                 { "Speed at which defocusing is largest, relative to the vehicles' estimated top speed.",
                   "Must be higher than TargetSpeedMinDoF",
                   estTopSpeedTxt,
                   targetSpeedMaxTxt });
 
-            mbCtx.FloatOptionCb("NearOutFocusMinSpeedDist", dof.NearOutFocusMinSpeedDist,
+            changed |= mbCtx.FloatOptionCb("NearOutFocusMinSpeedDist", dof.NearOutFocusMinSpeedDist,
                 0.0f, 10.0f, 0.01f, GetKbEntryFloat,
                 { "Distance of the plane that's out of focus, when traveling at or below 'TargetSpeedMinDoF'.",
                   "In meters.",
                   "Default: 0.00: nothing is blurred when going slow." });
 
-            mbCtx.FloatOptionCb("NearOutFocusMaxSpeedDist", dof.NearOutFocusMaxSpeedDist,
+            changed |= mbCtx.FloatOptionCb("NearOutFocusMaxSpeedDist", dof.NearOutFocusMaxSpeedDist,
                 0.0f, 10.0f, 0.01f, GetKbEntryFloat,
                 { "Distance of the plane that's out of focus, when traveling at or above 'TargetSpeedMaxDoF'.",
                   "In meters.",
                   "Default: 0.50: everything closer than 0.5 meters (1.6 feet) to the camera is blurred when going fast." });
 
-            mbCtx.FloatOptionCb("NearInFocusMinSpeedDist", dof.NearInFocusMinSpeedDist,
+            changed |= mbCtx.FloatOptionCb("NearInFocusMinSpeedDist", dof.NearInFocusMinSpeedDist,
                 0.1f, 100.0f, 0.1f, GetKbEntryFloat,
                 { "Distance of the plane that's in focus (when things stop being blurry), when traveling at or below 'TargetSpeedMinDoF'.",
                   "In meters.",
                   "Default: 0.10: Only objects closer than 0.1 meters (4 inches) to the camera are blurred when going slow.",
                   "Must be higher than 'NearOutFocusMinSpeedDist'." });
 
-            mbCtx.FloatOptionCb("NearInFocusMaxSpeedDist", dof.NearInFocusMaxSpeedDist,
+            changed |= mbCtx.FloatOptionCb("NearInFocusMaxSpeedDist", dof.NearInFocusMaxSpeedDist,
                 1.0f, 100.0f, 1.0f, GetKbEntryFloat,
                 { "Distance of the plane that's in focus (when things stop being blurry), when traveling at or above 'TargetSpeedMaxDoF'.",
                   "In meters.",
                   "Default: 20.0, where everything closer than 20 meters (65 feet) is blurred when going fast.",
                   "Must be much higher than 'NearOutFocusMaxSpeedDist'." });
 
-            mbCtx.FloatOptionCb("FarInFocusMinSpeedDist", dof.FarInFocusMinSpeedDist,
+            changed |= mbCtx.FloatOptionCb("FarInFocusMinSpeedDist", dof.FarInFocusMinSpeedDist,
                 100.0f, 100000.0f, 1.0f, GetKbEntryFloat,
                 { "Distance of the plane that's in focus (when things start being blurry), when traveling at or below 'TargetSpeedMinDoF'.",
                   "In meters.",
                   "Default: 100000: Practically infinite, no distant blur." });
 
-            mbCtx.FloatOptionCb("FarInFocusMaxSpeedDist", dof.FarInFocusMaxSpeedDist,
+            changed |= mbCtx.FloatOptionCb("FarInFocusMaxSpeedDist", dof.FarInFocusMaxSpeedDist,
                 100.0f, 100000.0f, 1.0f, GetKbEntryFloat,
                 { "Distance of the plane that's in focus (when things stop being blurry), when traveling at or above 'TargetSpeedMaxDoF'.",
                   "In meters.",
                   "Default: 2000.0: Everything farther than 2 km (1.2 miles) starts to get blurred when going fast." });
 
-            mbCtx.FloatOptionCb("FarOutFocusMinSpeedDist", dof.FarOutFocusMinSpeedDist,
+            changed |= mbCtx.FloatOptionCb("FarOutFocusMinSpeedDist", dof.FarOutFocusMinSpeedDist,
                 100.0f, 100000.0f, 0.01f, GetKbEntryFloat,
                 { "Distance of the plane that's out of focus, when traveling at or below 'TargetSpeedMinDoF'.",
                   "In meters.",
                   "Default: 100000: Practically infinite, no distant blur.",
                   "Must be higher or equal to 'FarInFocusMinSpeedDist'." });
 
-            mbCtx.FloatOptionCb("FarOutFocusMaxSpeedDist", dof.FarOutFocusMaxSpeedDist,
+            changed |= mbCtx.FloatOptionCb("FarOutFocusMaxSpeedDist", dof.FarOutFocusMaxSpeedDist,
                 100.0f, 100000.0f, 0.01f, GetKbEntryFloat,
                 { "Distance of the plane that's out of focus, when traveling at or above 'TargetSpeedMaxDoF'.",
                   "In meters.",
                   "Default: 10000: Everything farther than 10 km (6.2 miles) is as blurred can be, when going fast.",
                   "Must be higher than 'FarInFocusMaxSpeedDist'." });
 
-            mbCtx.FloatOptionCb("TargetAccelMinDoF", dof.TargetAccelMinDoF,
+            changed |= mbCtx.FloatOptionCb("TargetAccelMinDoF", dof.TargetAccelMinDoF,
                 0.0f, 200.0f, 0.05f, GetKbEntryFloat,
                 { "Acceleration where defocusing is reduced, in m/s^2.",
                   std::format("({:.2f} G)", dof.TargetAccelMinDoF / 9.81f),
                   "Default: 0.5G, to reduce blur when not accelerating or coasting." });
 
-            mbCtx.FloatOptionCb("TargetAccelMaxDoF", dof.TargetAccelMaxDoF,
+            changed |= mbCtx.FloatOptionCb("TargetAccelMaxDoF", dof.TargetAccelMaxDoF,
                 0.0f, 200.0f, 0.05f, GetKbEntryFloat,
                 { "Acceleration where defocusing is increased, in m/s^2.",
                   std::format("({:.2f} G)", dof.TargetAccelMaxDoF / 9.81f),
                   "Default: 1.0G, at which blur (for that speed) is maximized." });
 
-            mbCtx.FloatOptionCb("TargetAccelMinDoFMod", dof.TargetAccelMinDoFMod,
+            changed |= mbCtx.FloatOptionCb("TargetAccelMinDoFMod", dof.TargetAccelMinDoFMod,
                 0.0f, 10.0f, 0.01f, GetKbEntryFloat,
                 { "Modifier for blur reduction when at or below 'TargetAccelMinDoF' acceleration.",
                   "Default: 0.1, at low acceleration the near blur is moved closer to the camera, unblurring the dashboard and wheel." });
 
-            mbCtx.FloatOptionCb("TargetAccelMaxDoFMod", dof.TargetAccelMaxDoFMod,
+            changed |= mbCtx.FloatOptionCb("TargetAccelMaxDoFMod", dof.TargetAccelMaxDoFMod,
                 0.0f, 10.0f, 0.01f, GetKbEntryFloat,
                 { "Modifier for blur reduction when at or above 'TargetAccelMaxDoF' acceleration.",
                   "Default: 1.0, at high acceleration the near blur is as far forward as decided by the speed." });
+
+            if (changed) {
+                config->Dirty = true;
+                config->Mount[config->CamIndex].Dirty = true;
+            }
         });
 
     submenus.emplace_back("cam.manage.menu",
@@ -655,6 +736,7 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
 
                     if (PAD::IS_DISABLED_CONTROL_JUST_RELEASED(0, eControl::ControlVehicleHandbrake)) {
                         config->CamIndex = i;
+                        config->Dirty = true;
                     }
                 }
 
@@ -684,6 +766,9 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 ++config->Mount[i].Order;
                 --config->Mount[i + 1].Order;
                 std::swap(config->Mount[i], config->Mount[i + 1]);
+                config->Mount[i].Dirty = true;
+                config->Mount[i + 1].Dirty = true;
+                config->Dirty = true;
                 mbCtx.NextOption();
             }
             else if (queueMoveUp != -1) {
@@ -691,6 +776,9 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                 ++config->Mount[i - 1].Order;
                 --config->Mount[i].Order;
                 std::swap(config->Mount[i - 1], config->Mount[i]);
+                config->Mount[i - 1].Dirty = true;
+                config->Mount[i].Dirty = true;
+                config->Dirty = true;
                 mbCtx.PreviousOption();
             }
         });
@@ -723,12 +811,12 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
             mbCtx.FloatOptionCb("FarOutFocus", FPV::GetSettings().Debug.DoF.FarOutFocus, 0.0f, 100000.0f, 1.00f, GetKbEntryFloat);
 
             std::vector<std::string> shakeMaterialDetails = {
-                std::format("{} materials defined:", FPV::GetShakeData().MaterialReactionMap.size())
+                std::format("{} materials defined:", FPV::GetShakeData().MaterialReactions().size())
             };
 
-            for (const auto& mat : FPV::GetShakeData().MaterialReactionMap) {
+            for (const auto& mat : FPV::GetShakeData().MaterialReactions()) {
                 std::string matName;
-                auto matIdx = to_underlying(mat.first);
+                auto matIdx = to_underlying(mat.Material);
                 if (matIdx < sMaterialNames.size()) {
                     matName = sMaterialNames[matIdx];
                 }
@@ -736,10 +824,68 @@ std::vector<CScriptMenu<CFPVScript>::CSubmenu> FPV::BuildMenu() {
                     matName = std::format("UNK_{}", matIdx);
                 }
                 shakeMaterialDetails.push_back(std::format("{}: A: {:.2f}, F: {:.2f}",
-                    matName, mat.second.Amplitude, mat.second.Frequency));
+                    matName, mat.Params.Amplitude, mat.Params.Frequency));
             }
 
             mbCtx.OptionPlus("Shake materials", shakeMaterialDetails);
+
+            mbCtx.BoolOption("Show profiler", FPV::GetSettings().Debug.Profiler,
+                { "Shows how long parts of the script take each frame, over the last frames.",
+                  "Script includes Input, Inertia, Shake, DoF and Attach/rot." });
+
+            if (mbCtx.Option("Dump profiler CSV",
+                { "Writes the frame times currently in the profiler to the Profiles folder." })) {
+                const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+                const auto csvFile = Paths::GetModPath() / "Profiles" / std::format("{:%Y%m%d-%H%M%S}.csv", now);
+                if (FPV::GetProfiler().WriteCsv(csvFile)) {
+                    UI::Notify(std::format("Profiler data written to {}", csvFile.filename().string()));
+                }
+                else {
+                    UI::Notify("Failed to write profiler data.");
+                }
+            }
+
+            if (Tracing::Enabled()) {
+                if (mbCtx.Option("Stop zone trace",
+                    { "Stops recording zones and writes them to the Traces folder.",
+                      "Open the file in chrome://tracing or ui.perfetto.dev." })) {
+                    Tracing::SetEnabled(false);
+                    const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+                    const auto jsonFile = Paths::GetModPath() / "Traces" / std::format("{:%Y%m%d-%H%M%S}-zones.json", now);
+                    if (Tracing::WriteChromeTrace(jsonFile)) {
+                        UI::Notify(std::format("Zone trace written to {}", jsonFile.filename().string()));
+                    }
+                    else {
+                        UI::Notify("Failed to write zone trace.");
+                    }
+                }
+            }
+            else if (mbCtx.Option("Record zone trace",
+                { "Records how long each traced part of the script takes, including native calls.",
+                  std::format("Keeps the last {} zones per thread.", Tracing::BufferSize) })) {
+                Tracing::Clear();
+                Tracing::SetEnabled(true);
+            }
+
+            if (context.IsRecording()) {
+                if (mbCtx.Option("Stop camera trace",
+                    { std::format("Recorded {} frames so far.", context.RecordedFrames()) })) {
+                    context.StopRecording();
+                    UI::Notify(std::format("Camera trace stopped, {} frames recorded.", context.RecordedFrames()));
+                }
+            }
+            else if (mbCtx.Option("Record camera trace",
+                { "Records the camera inputs of every frame to the Traces folder.",
+                  "Replay a trace with FPVReplay to reproduce or profile the camera outside the game." })) {
+                const auto now = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+                const auto traceFile = Paths::GetModPath() / "Traces" / std::format("{:%Y%m%d-%H%M%S}.fpvtrace", now);
+                if (context.StartRecording(traceFile)) {
+                    UI::Notify(std::format("Recording camera trace to {}", traceFile.filename().string()));
+                }
+                else {
+                    UI::Notify("Failed to start camera trace, check the log.");
+                }
+            }
         });
 
     return submenus;
@@ -48,7 +48,7 @@ void FPV::CreateConfig(CConfig& config, Vehicle vehicle) {
     else
         UI::Notify("~r~An error occurred~s~, failed to save new configuration.\n"
             "Check the log file for further details.", true);
-    FPV::LoadConfigs();
+    FPV::ReloadConfigs();
 }
 
 void FPV::AddCamera(CConfig& config, CConfig::SCameraSettings* baseCam) {
@@ -78,7 +78,9 @@ void FPV::AddCamera(CConfig& config, CConfig::SCameraSettings* baseCam) {
     camera.Name = name;
     camera.Order = order;
 
+    camera.Dirty = true;
     config.Mount.push_back(camera);
+    config.Dirty = true;
     UI::Notify(std::format("Camera '{}' added.", name));
 }
 
@@ -101,8 +103,10 @@ void FPV::DeleteCamera(CConfig& config, const CConfig::SCameraSettings& camToDel
     for (auto& cam : config.Mount) {
         if (cam.Order > delOrder) {
             --cam.Order;
+            cam.Dirty = true;
         }
     }
+    config.Dirty = true;
     UI::Notify(std::format("Camera '{}' deleted.", delName));
 }
 
@@ -123,7 +127,9 @@ std::vector<std::string> FPV::FormatConfigInfo(const CConfig& cfg) {
         std::format("~h~{}", cfg.Name),
         std::format("Model: {}", modelName),
         std::format("Plate: [{}]", plate),
-        std::format("Cameras: {}", cfg.Mount.size())
+        cfg.IsLoaded() ?
+            std::format("Cameras: {}", cfg.Mount.size()) :
+            "Cameras: (not loaded yet)"
     };
 }
 
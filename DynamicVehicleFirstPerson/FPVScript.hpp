@@ -1,13 +1,19 @@
 #pragma once
 #include "Compatibility.hpp"
 #include "Config.hpp"
+#include "ConfigIndex.hpp"
 #include "ScriptSettings.hpp"
 #include "ShakeData.hpp"
 #include "VehicleMetaData.hpp"
-#include "Util/Timer.hpp"
+#include "VehicleSnapshot.hpp"
+#include "Solver/CameraSolver.hpp"
+#include "Solver/CameraTrace.hpp"
+#include "Util/FrameClock.hpp"
+#include "Util/Profiler.hpp"
 
 #include <inc/types.h>
-#include <PerlinNoise.h>
+#include <filesystem>
+#include <list>
 #include <memory>
 #include <string>
 
@@ -15,7 +21,10 @@ class CFPVScript {
 public:
     CFPVScript(const std::shared_ptr<CScriptSettings>& settings,
         const std::shared_ptr<CShakeData>& shakeData,
-        std::vector<CConfig>& configs);
+        std::list<CConfig>& configs,
+        const CConfigIndex& configIndex,
+        CProfiler& profiler,
+        const CFrameClock& clock);
     ~CFPVScript() = default;
 
     void UpdateActiveConfig();
@@ -31,85 +40,54 @@ public:
     void Cancel();
 
     void HideHead(bool remove) { hideHead(remove); }
+
+    // Records the camera solver input every frame, for FPVReplay.
+    bool StartRecording(const std::filesystem::path& traceFile);
+    void StopRecording();
+    bool IsRecording() const { return mTrace.IsOpen(); }
+    uint64_t RecordedFrames() const { return mTrace.FrameCount(); }
 private:
     void update();
-    
+    // Reads the vehicle state the solver needs, once per frame.
+    void updateSnapshot(Vehicle vehicle);
+    // Just the speed vector and world velocity, for frames without the camera.
+    void updateVelocitySnapshot(Vehicle vehicle);
+
     void init();
     void hideHead(bool remove);
 
-    float getRearLookAngle(ESeatPosition seatPosition, float lookLeftRight, float maxAngle);
-    void updateControllerLook(bool& lookingIntoGlass);
-    void updateMouseLook(bool& lookingIntoGlass);
-    void updateWheelLook(bool& lookingIntoGlass);
-
-    void updateRotationCameraMovement(const CConfig::SMovement& movement);
-
-    float getMovementLerpFactor(const CConfig::SMovement& movement) const;
-    void updateLongitudinalCameraMovement(const CConfig::SMovement& movement);
-    void updateLateralCameraMovement(const CConfig::SMovement& movement);
-    void updateVerticalCameraMovement(const CConfig::SMovement& movement);
-    void updatePitchCameraMovement(const CConfig::SMovement& movement);
-
-    void updateDoF(const CConfig::SDoF& dof);
-
-    Vector3 getLeanOffset(bool lookingIntoGlass) const;
-    Vector3 getHorizonLockRotation();
-
-    // X, Z, Roll
-    Vector3 getShakeFromSpeed();
-    Vector3 getShakeFromTerrain();
+    // Natives and controls -> solver input. The camera math itself is in CCameraSolver.
+    SCameraSolverInput getSolverInput(const CConfig::SCameraSettings& mount);
+    void updateDoF(const SCameraSolverOutput& camera);
+    void showDebug(const CConfig::SCameraSettings& mount);
 
     // Config management
     const std::shared_ptr<CScriptSettings>& mSettings;
     const std::shared_ptr<CShakeData>& mShakeData;
-    std::vector<CConfig>& mConfigs;
+    std::list<CConfig>& mConfigs;
+    const CConfigIndex& mConfigIndex;
     CConfig* mActiveConfig = nullptr;
 
-    // Correct offset for <1290 on load
-    unsigned mFpvCamOffsetXOffset = 0x450;
+    CProfiler& mProfiler;
+    // Sampled by the script loop, before Tick()
+    const CFrameClock& mClock;
 
     Vehicle mVehicle;
-    // Just create a new one each time mVehicle changes
+    // Just create a new one each time mVehicle changes.
+    // Static model data is cached per model inside.
     CVehicleMetaData mVehicleData;
 
-    Cam mHandle = -1;
-
-    Vector3 mRotation{};
+    // Natives for mVehicle are read once per tick into here
+    SVehicleSnapshot mSnapshot;
 
-    CSysTimer mLookResetTimer;
-
-    // Accumulated values for mouse look
-    Vector3 mLookAcc{};
-
-    // rotation camera movement
-    float mInertiaDirectionLookAngle = 0.0f;
-
-    // forward camera movement
-    Vector3 mInertiaMove{};
-
-    // in degrees
-    float mInertiaPitch = 0.0f;
+    Cam mHandle = -1;
 
-    // in degrees
-    float mDynamicPitch = 0.0f;
+    CCameraSolver mSolver;
+    CCameraTraceWriter mTrace;
 
     bool mHeadRemoved = false;
     int savedHeadProp = -1;
     int savedHeadPropTx = -1;
     int savedEyesProp = -1;
     int savedEyesPropTx = -1;
-
-    float mAverageAccel = 0.0f;
-
-    // For Manual Transmission
-    // Figure out which side to look "back" with:
-    // When the LookRight is pressed first, and then LookLeft is pressed
-    // camera should look back over the right shoulder - otherwise left shoulder.
-    bool mMTLookRightPrev = false;
-    bool mMTLookLeftPrev = false;
-    bool mMTLookBackRightShoulder = false;
-
-    std::unique_ptr<PerlinNoise> mPerlinNoise;
-    double mCumTimeSpeed = 0.0;
-    double mCumTimeTerrain = 0.0;
 };
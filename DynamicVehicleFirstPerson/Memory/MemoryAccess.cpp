@@ -1,10 +1,14 @@
 #include "MemoryAccess.hpp"
+#include "PatternScan.hpp"
 
 #include "../Util/Logger.hpp"
 #include "../Util/Strings.hpp"
 #include <inc/main.h>
 #include <Windows.h>
 #include <Psapi.h>
+#include <chrono>
+#include <fstream>
+#include <unordered_map>
 #include <vector>
 
 namespace Memory {
@@ -12,16 +16,115 @@ namespace Memory {
     uintptr_t(*GetModelInfo)(unsigned int modelHash, int* index) = nullptr;
 
     float* timeScaleAddress = nullptr;
+
+    struct SPendingPattern {
+        SPattern Pattern;
+        std::function<void(uintptr_t)> OnResult;
+    };
+    std::vector<SPendingPattern> pendingPatterns;
+
+    void getImageRange(const uint8_t*& begin, const uint8_t*& end) {
+        MODULEINFO modInfo{};
+        GetModuleInformation(GetCurrentProcess(), GetModuleHandle(nullptr), &modInfo, sizeof(MODULEINFO));
+
+        begin = static_cast<const uint8_t*>(modInfo.lpBaseOfDll);
+        end = begin + modInfo.SizeOfImage;
+    }
+
+    // Identifies the game build. The PE header holds the link timestamp,
+    // section layout and checksum, so hashing it covers more than size and time.
+    struct SImageKey {
+        uint32_t ImageSize = 0;
+        uint32_t TimeStamp = 0;
+        uint64_t HeaderHash = 0;
+
+        bool operator==(const SImageKey&) const = default;
+    };
+
+    constexpr uint32_t signatureCacheVersion = 1;
+
+    SImageKey getImageKey(const uint8_t* base) {
+        const auto* dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        const auto* ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+
+        SImageKey key{
+            .ImageSize = ntHeaders->OptionalHeader.SizeOfImage,
+            .TimeStamp = ntHeaders->FileHeader.TimeDateStamp,
+        };
+
+        // FNV-1a
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (uint32_t i = 0; i < ntHeaders->OptionalHeader.SizeOfHeaders; ++i) {
+            hash = (hash ^ base[i]) * 0x100000001B3ull;
+        }
+        key.HeaderHash = hash;
+        return key;
+    }
+
+    // Text file: a header line with the version and image key,
+    // then one "<pattern hash> <offset from image base>" line per found pattern.
+    std::unordered_map<uint64_t, uint32_t> readSignatureCache(const std::filesystem::path& cacheFile,
+        const SImageKey& imageKey) {
+        std::unordered_map<uint64_t, uint32_t> offsets;
+
+        std::ifstream file(cacheFile);
+        if (!file.is_open()) {
+            return offsets;
+        }
+
+        uint32_t version = 0;
+        SImageKey fileKey{};
+        file >> version >> std::hex >> fileKey.ImageSize >> fileKey.TimeStamp >> fileKey.HeaderHash;
+        if (!file || version != signatureCacheVersion || !(fileKey == imageKey)) {
+            LOG(INFO, "[Memory] Signature cache is for another game build, rescanning");
+            return offsets;
+        }
+
+        uint64_t patternHash;
+        uint32_t offset;
+        while (file >> patternHash >> offset) {
+            offsets[patternHash] = offset;
+        }
+        return offsets;
+    }
+
+    void writeSignatureCache(const std::filesystem::path& cacheFile, const SImageKey& imageKey,
+        const std::vector<const uint8_t*>& results, const uint8_t* base) {
+        std::ofstream file(cacheFile, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG(WARN, "[Memory] Failed to write signature cache {}", cacheFile.string());
+            return;
+        }
+
+        file << signatureCacheVersion << std::hex << " "
+            << imageKey.ImageSize << " " << imageKey.TimeStamp << " " << imageKey.HeaderHash << "\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i] == nullptr) {
+                continue;
+            }
+            file << PatternHash(pendingPatterns[i].Pattern) << " "
+                << static_cast<uint32_t>(results[i] - base) << "\n";
+        }
+    }
+
+    uintptr_t findPattern(const SPattern& pattern) {
+        const uint8_t* begin;
+        const uint8_t* end;
+        getImageRange(begin, end);
+        return reinterpret_cast<uintptr_t>(ScanPattern(begin, end, pattern));
+    }
 }
 
 void Memory::Init() {
-    auto addr = FindPattern("\x83\xF9\xFF\x74\x31\x4C\x8B\x0D\x00\x00\x00\x00\x44\x8B\xC1\x49\x8B\x41\x08",
-        "xxxxxxxx????xxxxxxx");
-    if (!addr) LOG(ERROR, "Couldn't find GetAddressOfEntity");
-    GetAddressOfEntity = reinterpret_cast<uintptr_t(*)(int)>(addr);
+    AddPattern("\x83\xF9\xFF\x74\x31\x4C\x8B\x0D\x00\x00\x00\x00\x44\x8B\xC1\x49\x8B\x41\x08",
+        "xxxxxxxx????xxxxxxx",
+        [](uintptr_t addr) {
+            if (!addr) LOG(ERROR, "Couldn't find GetAddressOfEntity");
+            GetAddressOfEntity = reinterpret_cast<uintptr_t(*)(int)>(addr);
+        });
 
     if (getGameVersion() < 58) {
-        addr = FindPattern(
+        AddPattern(
             "\x0F\xB7\x05\x00\x00\x00\x00"
             "\x45\x33\xC9\x4C\x8B\xDA\x66\x85\xC0"
             "\x0F\x84\x00\x00\x00\x00"
@@ -33,91 +136,115 @@ void Memory::Init() {
             "xx????"
             "xxxxxxxxxxxx"
             "xx????"
-            "xxxxxxxxxxx");
-
-        if (!addr) {
-            LOG(ERROR, "Couldn't find GetModelInfo");
-        }
+            "xxxxxxxxxxx",
+            [](uintptr_t addr) {
+                if (!addr) {
+                    LOG(ERROR, "Couldn't find GetModelInfo");
+                }
+                GetModelInfo = reinterpret_cast<uintptr_t(*)(unsigned int modelHash, int* index)>(addr);
+            });
     }
     else {
-        addr = FindPattern("\xEB\x09\x41\x3B\x0A\x74\x54", "xxxxxxx");
-        if (!addr) {
-            LOG(ERROR, "Couldn't find GetModelInfo (v58+)");
-        }
-        addr = addr - 0x2C;
+        AddPattern("\xEB\x09\x41\x3B\x0A\x74\x54", "xxxxxxx",
+            [](uintptr_t addr) {
+                if (!addr) {
+                    LOG(ERROR, "Couldn't find GetModelInfo (v58+)");
+                }
+                addr = addr - 0x2C;
+                GetModelInfo = reinterpret_cast<uintptr_t(*)(unsigned int modelHash, int* index)>(addr);
+            });
     }
 
-    GetModelInfo = reinterpret_cast<uintptr_t(*)(unsigned int modelHash, int* index)>(addr);
-
     // From ScriptHookVDotNet
-    addr = FindPattern("\xF3\x0F\x11\x05\x00\x00\x00\x00\xF3\x0F\x10\x08\x0F\x2F\xC8\x73\x03\x0F\x28\xC1\x48\x83\xC0\x04\x49\x2B",
-        "xxxx????xxxxxxxxxxxxxxxxxx");
-    if (!addr) {
-        LOG(ERROR, "Couldn't find TimeScaleAddress1");
-    }
-    else {
-        auto timeScaleArrayAddress = (float*)(*(int*)(addr + 4) + addr + 8);
-        if (timeScaleArrayAddress != nullptr)
-            // SET_TIME_SCALE changes the 2nd element, so obtain the address of it
-            timeScaleAddress = timeScaleArrayAddress + 1;
-        else
-            LOG(ERROR, "Couldn't find TimeScaleAddress2");
-    }
+    AddPattern("\xF3\x0F\x11\x05\x00\x00\x00\x00\xF3\x0F\x10\x08\x0F\x2F\xC8\x73\x03\x0F\x28\xC1\x48\x83\xC0\x04\x49\x2B",
+        "xxxx????xxxxxxxxxxxxxxxxxx",
+        [](uintptr_t addr) {
+            if (!addr) {
+                LOG(ERROR, "Couldn't find TimeScaleAddress1");
+            }
+            else {
+                auto timeScaleArrayAddress = (float*)(*(int*)(addr + 4) + addr + 8);
+                if (timeScaleArrayAddress != nullptr)
+                    // SET_TIME_SCALE changes the 2nd element, so obtain the address of it
+                    timeScaleAddress = timeScaleArrayAddress + 1;
+                else
+                    LOG(ERROR, "Couldn't find TimeScaleAddress2");
+            }
+        });
 }
 
-uintptr_t Memory::FindPattern(const char* pattern, const char* mask) {
-    MODULEINFO modInfo = { nullptr };
-    GetModuleInformation(GetCurrentProcess(), GetModuleHandle(nullptr), &modInfo, sizeof(MODULEINFO));
-
-    const char* start_offset = reinterpret_cast<const char*>(modInfo.lpBaseOfDll);
-    const uintptr_t size = static_cast<uintptr_t>(modInfo.SizeOfImage);
-
-    intptr_t pos = 0;
-    const uintptr_t searchLen = static_cast<uintptr_t>(strlen(mask) - 1);
+void Memory::AddPattern(const char* pattStr, std::function<void(uintptr_t)> onResult) {
+    pendingPatterns.push_back({ ParsePattern(pattStr), std::move(onResult) });
+}
 
-    for (const char* retAddress = start_offset; retAddress < start_offset + size; retAddress++) {
-        if (*retAddress == pattern[pos] || mask[pos] == '?') {
-            if (mask[pos + 1] == '\0')
-                return (reinterpret_cast<uintptr_t>(retAddress) - searchLen);
-            pos++;
-        }
-        else {
-            pos = 0;
-        }
-    }
-    return 0;
+void Memory::AddPattern(const char* pattern, const char* mask, std::function<void(uintptr_t)> onResult) {
+    pendingPatterns.push_back({ ParsePattern(pattern, mask), std::move(onResult) });
 }
 
-uintptr_t Memory::FindPattern(const char* pattStr) {
-    std::vector<std::string> bytesStr = StrUtil::Split(pattStr, ' ');
+void Memory::ScanPatterns(const std::filesystem::path& cacheFile) {
+    if (pendingPatterns.empty()) {
+        return;
+    }
 
-    MODULEINFO modInfo{};
-    GetModuleInformation(GetCurrentProcess(), GetModuleHandle(nullptr), &modInfo, sizeof(MODULEINFO));
+    const uint8_t* begin;
+    const uint8_t* end;
+    getImageRange(begin, end);
 
-    auto* start_offset = static_cast<uint8_t*>(modInfo.lpBaseOfDll);
-    const auto size = static_cast<uintptr_t>(modInfo.SizeOfImage);
+    const SImageKey imageKey = getImageKey(begin);
+    std::unordered_map<uint64_t, uint32_t> cachedOffsets;
+    if (!cacheFile.empty()) {
+        cachedOffsets = readSignatureCache(cacheFile, imageKey);
+    }
 
-    uintptr_t pos = 0;
-    const uintptr_t searchLen = bytesStr.size();
-    std::vector<uint8_t> bytes;
-    // Thanks Zolika for the performance improvement!
-    for (const auto& str : bytesStr) {
-        if (str == "??" || str == "?") bytes.push_back(0);
-        else bytes.push_back(static_cast<uint8_t>(std::strtoul(str.c_str(), nullptr, 16)));
+    std::vector<const uint8_t*> results(pendingPatterns.size(), nullptr);
+    std::vector<size_t> toScan;
+    std::vector<SPattern> patterns;
+    for (size_t i = 0; i < pendingPatterns.size(); ++i) {
+        const SPattern& pattern = pendingPatterns[i].Pattern;
+        auto cached = cachedOffsets.find(PatternHash(pattern));
+        // Don't trust the cache blindly, the pattern needs to be there still.
+        if (cached != cachedOffsets.end() && PatternMatches(begin + cached->second, end, pattern)) {
+            results[i] = begin + cached->second;
+            continue;
+        }
+        toScan.push_back(i);
+        patterns.push_back(pattern);
     }
 
-    for (auto* retAddress = start_offset; retAddress < start_offset + size; retAddress++) {
-        if (bytesStr[pos] == "??" || bytesStr[pos] == "?" ||
-            *retAddress == bytes[pos]) {
-            if (pos + 1 == bytesStr.size())
-                return (reinterpret_cast<uintptr_t>(retAddress) - searchLen + 1);
-            pos++;
+    if (!patterns.empty()) {
+        const auto scanStart = std::chrono::steady_clock::now();
+        const auto scanResults = Memory::ScanPatterns(begin, end, patterns);
+        const auto scanTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - scanStart);
+        LOG(DEBUG, "[Memory] Scanned for {} patterns in {:.2f} ms ({} cached)",
+            patterns.size(), scanTime.count() / 1000.0, pendingPatterns.size() - patterns.size());
+
+        for (size_t i = 0; i < toScan.size(); ++i) {
+            results[toScan[i]] = scanResults[i];
         }
-        else {
-            pos = 0;
+
+        if (!cacheFile.empty()) {
+            writeSignatureCache(cacheFile, imageKey, results, begin);
         }
     }
-    return 0;
+    else {
+        LOG(DEBUG, "[Memory] All {} patterns cached", pendingPatterns.size());
+    }
+
+    // Callbacks run here on the calling thread, in the order they were added.
+    auto pending = std::move(pendingPatterns);
+    pendingPatterns.clear();
+    for (size_t i = 0; i < pending.size(); ++i) {
+        pending[i].OnResult(reinterpret_cast<uintptr_t>(results[i]));
+    }
+}
+
+uintptr_t Memory::FindPattern(const char* pattern, const char* mask) {
+    return findPattern(ParsePattern(pattern, mask));
+}
+
+uintptr_t Memory::FindPattern(const char* pattStr) {
+    return findPattern(ParsePattern(pattStr));
 }
 
 float Memory::GetTimeScale() {
@@ -1,12 +1,24 @@
 #pragma once
 
 #include <cstdint>
+#include <filesystem>
+#include <functional>
 
 namespace Memory {
+    // Only registers patterns, ScanPatterns resolves them.
     void Init();
     uintptr_t FindPattern(const char* pattern, const char* mask);
     uintptr_t FindPattern(const char* pattStr);
 
+    // Patterns added here are all resolved by one ScanPatterns call, in a single pass
+    // over the game image. onResult gets the first match, or 0 if there is none.
+    void AddPattern(const char* pattStr, std::function<void(uintptr_t)> onResult);
+    void AddPattern(const char* pattern, const char* mask, std::function<void(uintptr_t)> onResult);
+
+    // With a cache file, results from an earlier run are reused if the game executable
+    // is the same build and the pattern still matches there. Only the rest is scanned.
+    void ScanPatterns(const std::filesystem::path& cacheFile = {});
+
     extern uintptr_t(*GetAddressOfEntity)(int entity);
     extern uintptr_t(*GetModelInfo)(unsigned int modelHash, int* index);
 
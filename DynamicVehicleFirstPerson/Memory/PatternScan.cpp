@@ -0,0 +1,472 @@
+#include "PatternScan.hpp"
+
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSSE3
+#else
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+namespace {
+    // Small enough to stay in L2 for the patterns that are scanned on their own.
+    constexpr size_t chunkSize = 64 * 1024;
+    constexpr unsigned maxThreads = 8;
+
+    // Rough ranking of how common a byte is in x64 game code, most common first.
+    // Picking the rarest bytes as anchors keeps false candidates down.
+    constexpr uint8_t commonBytes[] = {
+        0x00, 0xFF, 0x48, 0x8B, 0x0F, 0xCC, 0x89, 0x24, 0x4C, 0x44, 0xE8, 0x85,
+        0xC0, 0x01, 0x08, 0x83, 0x10, 0x20, 0x8D, 0x45, 0x41, 0x49, 0x4D, 0xC3,
+        0x74, 0x75, 0x33, 0xF3, 0x40, 0x28, 0x18, 0x30, 0x38, 0xEB, 0x5C, 0xC7,
+    };
+
+    int commonness(uint8_t byte) {
+        constexpr int count = static_cast<int>(sizeof(commonBytes));
+        for (int i = 0; i < count; ++i) {
+            if (commonBytes[i] == byte) {
+                return count - i;
+            }
+        }
+        return 0;
+    }
+
+    void pickAnchors(Memory::SPattern& pattern) {
+        int best = -1;
+        int second = -1;
+        for (size_t i = 0; i < pattern.Bytes.size(); ++i) {
+            if (!pattern.Mask[i]) {
+                continue;
+            }
+            if (best == -1 || commonness(pattern.Bytes[i]) < commonness(pattern.Bytes[best])) {
+                second = best;
+                best = static_cast<int>(i);
+            }
+            else if (second == -1 || commonness(pattern.Bytes[i]) < commonness(pattern.Bytes[second])) {
+                second = static_cast<int>(i);
+            }
+        }
+
+        // All wildcards or a single fixed byte: compare the same byte twice.
+        pattern.Anchor = best == -1 ? 0 : static_cast<size_t>(best);
+        pattern.SecondAnchor = second == -1 ? pattern.Anchor : static_cast<size_t>(second);
+    }
+
+    bool matchesAt(const uint8_t* address, const Memory::SPattern& pattern) {
+        for (size_t i = 0; i < pattern.Bytes.size(); ++i) {
+            if ((address[i] ^ pattern.Bytes[i]) & pattern.Mask[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The game's minimum spec includes CPUs without SSSE3 (Phenom).
+    bool hasSsse3() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+#else
+        return __builtin_cpu_supports("ssse3");
+#endif
+    }
+
+    // Bytes the sweep looks at per position, see SAnchorTable.
+    constexpr size_t windowSize = 4;
+    // Buckets per mask (bits in a byte), and up to two masks.
+    constexpr size_t bucketsPerMask = 8;
+    constexpr size_t maxMasks = 2;
+
+    // Start of the window the sweep looks for. Its first two bytes are fixed,
+    // then the most fixed bytes and the rarest ones win. False if there are
+    // no two fixed bytes in a row.
+    bool pickAnchorWindow(const Memory::SPattern& pattern, size_t& offset) {
+        auto score = [&](size_t start) {
+            int result = 0;
+            for (size_t i = start; i < std::min(start + windowSize, pattern.Bytes.size()); ++i) {
+                if (pattern.Mask[i]) {
+                    result += 256 - commonness(pattern.Bytes[i]);
+                }
+            }
+            return result;
+        };
+
+        bool found = false;
+        for (size_t i = 0; i + 1 < pattern.Bytes.size(); ++i) {
+            if (pattern.Mask[i] && pattern.Mask[i + 1] && (!found || score(i) > score(offset))) {
+                offset = i;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    struct SAnchor {
+        size_t Pattern;
+        // Where the window starts in the pattern
+        size_t Offset;
+        // Second window byte, the first is the bucket in SAnchorTable
+        uint8_t Second;
+    };
+
+    // Patterns with an anchor window, for the sweep. The patterns are also
+    // spread over 8 buckets per mask, one bit each in the nibble masks. A
+    // position is a candidate if some bucket has both nibbles of all window
+    // bytes, so a byte only counts together with the others of the same
+    // bucket. Past 8 patterns a second mask keeps the buckets small, else
+    // false candidates grow quickly with the pattern count.
+    struct SAnchorTable {
+        // Sorted by the first window byte.
+        std::vector<SAnchor> Anchors;
+        // Anchors[BucketBegin[b], BucketBegin[b + 1]) start with byte b.
+        std::array<uint32_t, 257> BucketBegin{};
+        // Bit (first | second << 8) set for each window start. Rules out most
+        // of what the nibble masks let through, before the bucket is checked.
+        std::array<uint64_t, 65536 / 64> Pairs{};
+        // 1, or maxMasks for more than 8 patterns
+        size_t Masks = 1;
+        // Per mask and window byte, the buckets that accept each low and high nibble.
+        __m128i LowNibbles[maxMasks][windowSize];
+        __m128i HighNibbles[maxMasks][windowSize];
+    };
+
+    SAnchorTable makeAnchorTable(const std::vector<Memory::SPattern>& patterns,
+        const std::vector<std::pair<size_t, size_t>>& windows) {
+        SAnchorTable table;
+        for (const auto& [pattern, offset] : windows) {
+            const uint8_t first = patterns[pattern].Bytes[offset];
+            const uint8_t second = patterns[pattern].Bytes[offset + 1];
+            table.Anchors.push_back({ pattern, offset, second });
+            ++table.BucketBegin[first + 1];
+            const unsigned pair = first | second << 8;
+            table.Pairs[pair / 64] |= 1ull << (pair % 64);
+        }
+        std::stable_sort(table.Anchors.begin(), table.Anchors.end(), [&](const SAnchor& a, const SAnchor& b) {
+            return patterns[a.Pattern].Bytes[a.Offset] < patterns[b.Pattern].Bytes[b.Offset];
+        });
+        for (size_t b = 1; b < table.BucketBegin.size(); ++b) {
+            table.BucketBegin[b] += table.BucketBegin[b - 1];
+        }
+
+        // Neighbours in the sorted order share bytes, and so share nibbles.
+        table.Masks = table.Anchors.size() > bucketsPerMask ? maxMasks : 1;
+        const size_t bucketCount = table.Masks * bucketsPerMask;
+        alignas(16) uint8_t low[maxMasks][windowSize][16] = {};
+        alignas(16) uint8_t high[maxMasks][windowSize][16] = {};
+        for (size_t a = 0; a < table.Anchors.size(); ++a) {
+            const size_t bucket = a * bucketCount / table.Anchors.size();
+            const size_t mask = bucket / bucketsPerMask;
+            const uint8_t bit = static_cast<uint8_t>(1 << (bucket % bucketsPerMask));
+            const Memory::SPattern& pattern = patterns[table.Anchors[a].Pattern];
+            for (size_t w = 0; w < windowSize; ++w) {
+                const size_t i = table.Anchors[a].Offset + w;
+                if (i < pattern.Bytes.size() && pattern.Mask[i]) {
+                    low[mask][w][pattern.Bytes[i] & 0x0F] |= bit;
+                    high[mask][w][pattern.Bytes[i] >> 4] |= bit;
+                    continue;
+                }
+                for (int n = 0; n < 16; ++n) {
+                    low[mask][w][n] |= bit;
+                    high[mask][w][n] |= bit;
+                }
+            }
+        }
+        for (size_t mask = 0; mask < maxMasks; ++mask) {
+            for (size_t w = 0; w < windowSize; ++w) {
+                table.LowNibbles[mask][w] = _mm_load_si128(reinterpret_cast<const __m128i*>(low[mask][w]));
+                table.HighNibbles[mask][w] = _mm_load_si128(reinterpret_cast<const __m128i*>(high[mask][w]));
+            }
+        }
+        return table;
+    }
+
+    void storeLowest(std::atomic<uintptr_t>& found, uintptr_t address) {
+        uintptr_t current = found.load(std::memory_order_relaxed);
+        while (address < current &&
+            !found.compare_exchange_weak(current, address, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Checks the patterns whose anchor window could start at address.
+    void checkAnchors(const uint8_t* address, const uint8_t* begin, const uint8_t* end,
+        const SAnchorTable& table, const std::vector<Memory::SPattern>& patterns,
+        std::atomic<uintptr_t>* found) {
+        const uint32_t bucketEnd = table.BucketBegin[address[0] + 1];
+        for (uint32_t a = table.BucketBegin[address[0]]; a < bucketEnd; ++a) {
+            const SAnchor& anchor = table.Anchors[a];
+            if (anchor.Second != address[1] || static_cast<size_t>(address - begin) < anchor.Offset) {
+                continue;
+            }
+            const uint8_t* start = address - anchor.Offset;
+            const Memory::SPattern& pattern = patterns[anchor.Pattern];
+            if (static_cast<size_t>(end - start) < pattern.Bytes.size() ||
+                reinterpret_cast<uintptr_t>(start) >= found[anchor.Pattern].load(std::memory_order_relaxed) ||
+                !matchesAt(start, pattern)) {
+                continue;
+            }
+            storeLowest(found[anchor.Pattern], reinterpret_cast<uintptr_t>(start));
+        }
+    }
+
+    // One pass over the windows starting in [chunk, chunkEnd), for all patterns in the table at once.
+    template <size_t Masks>
+    TARGET_SSSE3 void sweepAnchors(const uint8_t* chunk, const uint8_t* chunkEnd,
+        const uint8_t* begin, const uint8_t* end, const SAnchorTable& table,
+        const std::vector<Memory::SPattern>& patterns, std::atomic<uintptr_t>* found) {
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const uint8_t* address = chunk;
+
+        // The last load reads up to address + 15 + windowSize - 1, which has to stay below end.
+        for (; chunkEnd - address >= 16 && static_cast<size_t>(end - address) >= 16 + windowSize - 1; address += 16) {
+            __m128i buckets[Masks];
+            for (size_t mask = 0; mask < Masks; ++mask) {
+                buckets[mask] = _mm_set1_epi8(-1);
+            }
+            for (size_t w = 0; w < windowSize; ++w) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(address + w));
+                __m128i low = _mm_and_si128(bytes, nibble);
+                __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+                for (size_t mask = 0; mask < Masks; ++mask) {
+                    buckets[mask] = _mm_and_si128(buckets[mask], _mm_and_si128(
+                        _mm_shuffle_epi8(table.LowNibbles[mask][w], low),
+                        _mm_shuffle_epi8(table.HighNibbles[mask][w], high)));
+                }
+            }
+            __m128i any = buckets[0];
+            for (size_t mask = 1; mask < Masks; ++mask) {
+                any = _mm_or_si128(any, buckets[mask]);
+            }
+            unsigned candidates = ~static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128()))) & 0xFFFF;
+
+            while (candidates != 0) {
+                const uint8_t* candidate = address + std::countr_zero(candidates);
+                const unsigned pair = candidate[0] | candidate[1] << 8;
+                if (table.Pairs[pair / 64] & (1ull << (pair % 64))) {
+                    checkAnchors(candidate, begin, end, table, patterns, found);
+                }
+                candidates &= candidates - 1;
+            }
+        }
+
+        for (; address < chunkEnd && end - address >= 2; ++address) {
+            checkAnchors(address, begin, end, table, patterns, found);
+        }
+    }
+}
+
+Memory::SPattern Memory::ParsePattern(const char* pattStr) {
+    SPattern pattern;
+    std::istringstream tokens(pattStr);
+    std::string str;
+    while (tokens >> str) {
+        if (str == "??" || str == "?") {
+            pattern.Bytes.push_back(0);
+            pattern.Mask.push_back(0x00);
+        }
+        else {
+            pattern.Bytes.push_back(static_cast<uint8_t>(std::strtoul(str.c_str(), nullptr, 16)));
+            pattern.Mask.push_back(0xFF);
+        }
+    }
+    pickAnchors(pattern);
+    return pattern;
+}
+
+Memory::SPattern Memory::ParsePattern(const char* pattern, const char* mask) {
+    SPattern result;
+    const size_t length = strlen(mask);
+    for (size_t i = 0; i < length; ++i) {
+        bool wildcard = mask[i] == '?';
+        result.Bytes.push_back(wildcard ? 0 : static_cast<uint8_t>(pattern[i]));
+        result.Mask.push_back(wildcard ? 0x00 : 0xFF);
+    }
+    pickAnchors(result);
+    return result;
+}
+
+const uint8_t* Memory::ScanPattern(const uint8_t* begin, const uint8_t* end, const SPattern& pattern) {
+    const size_t length = pattern.Bytes.size();
+    if (length == 0 || begin == nullptr || static_cast<size_t>(end - begin) < length) {
+        return nullptr;
+    }
+
+    // Last address a match can start at
+    const uint8_t* last = end - length;
+    const uint8_t* address = begin;
+
+    if (pattern.Mask[pattern.Anchor]) {
+        const __m128i anchor = _mm_set1_epi8(static_cast<char>(pattern.Bytes[pattern.Anchor]));
+        const __m128i secondAnchor = _mm_set1_epi8(static_cast<char>(pattern.Bytes[pattern.SecondAnchor]));
+
+        // Test 16 start positions at once. Both loads stay below end,
+        // as address + 15 + anchor <= last + anchor < end.
+        for (; address + 15 <= last; address += 16) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(address + pattern.Anchor));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(address + pattern.SecondAnchor));
+            unsigned candidates = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, anchor), _mm_cmpeq_epi8(second, secondAnchor))));
+
+            while (candidates != 0) {
+                const uint8_t* candidate = address + std::countr_zero(candidates);
+                if (matchesAt(candidate, pattern)) {
+                    return candidate;
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+
+    for (; address <= last; ++address) {
+        if (matchesAt(address, pattern)) {
+            return address;
+        }
+    }
+    return nullptr;
+}
+
+bool Memory::PatternMatches(const uint8_t* address, const uint8_t* end, const SPattern& pattern) {
+    if (address == nullptr || end < address ||
+        static_cast<size_t>(end - address) < pattern.Bytes.size()) {
+        return false;
+    }
+    return matchesAt(address, pattern);
+}
+
+uint64_t Memory::PatternHash(const SPattern& pattern) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < pattern.Bytes.size(); ++i) {
+        hash = (hash ^ (pattern.Bytes[i] & pattern.Mask[i])) * 0x100000001B3ull;
+        hash = (hash ^ pattern.Mask[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::vector<const uint8_t*> Memory::ScanPatterns(const uint8_t* begin, const uint8_t* end,
+    const std::vector<SPattern>& patterns, unsigned threads) {
+    std::vector<const uint8_t*> results(patterns.size(), nullptr);
+    if (patterns.empty() || begin == nullptr || end <= begin) {
+        return results;
+    }
+
+    // Lowest match so far per pattern. Chunks past it don't need that pattern anymore.
+    constexpr uintptr_t notFound = std::numeric_limits<uintptr_t>::max();
+    auto found = std::make_unique<std::atomic<uintptr_t>[]>(patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        found[i].store(notFound, std::memory_order_relaxed);
+    }
+
+    // Patterns with an anchor window are found in one sweep over the range. The
+    // rest (or all of them, without SSSE3) are scanned on their own per chunk.
+    std::vector<std::pair<size_t, size_t>> windows;
+    std::vector<size_t> single;
+    const bool canSweep = hasSsse3();
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        size_t offset = 0;
+        if (patterns[i].Bytes.empty()) {
+            continue;
+        }
+        if (canSweep && pickAnchorWindow(patterns[i], offset)) {
+            windows.emplace_back(i, offset);
+        }
+        else {
+            single.push_back(i);
+        }
+    }
+    const SAnchorTable table = makeAnchorTable(patterns, windows);
+
+    auto scanRegion = [&](const uint8_t* regionBegin, const uint8_t* regionEnd) {
+        for (const uint8_t* chunk = regionBegin; chunk < regionEnd; chunk += chunkSize) {
+            const uint8_t* chunkEnd = std::min<const uint8_t*>(chunk + chunkSize, regionEnd);
+            const uintptr_t chunkAddress = reinterpret_cast<uintptr_t>(chunk);
+
+            // A window found from here on can still start before chunk, by up to its offset.
+            bool sweep = false;
+            for (const SAnchor& anchor : table.Anchors) {
+                if (found[anchor.Pattern].load(std::memory_order_relaxed) > chunkAddress + anchor.Offset) {
+                    sweep = true;
+                    break;
+                }
+            }
+            if (sweep && table.Masks == 1) {
+                sweepAnchors<1>(chunk, chunkEnd, begin, end, table, patterns, found.get());
+            }
+            else if (sweep) {
+                sweepAnchors<maxMasks>(chunk, chunkEnd, begin, end, table, patterns, found.get());
+            }
+
+            bool anyLeft = sweep;
+            for (size_t i : single) {
+                if (found[i].load(std::memory_order_relaxed) <= chunkAddress) {
+                    continue;
+                }
+                anyLeft = true;
+
+                // Matches may start in this chunk and run into the next one.
+                const size_t overlap = patterns[i].Bytes.size() - 1;
+                const uint8_t* scanEnd = static_cast<size_t>(end - chunkEnd) > overlap ? chunkEnd + overlap : end;
+                const uint8_t* match = ScanPattern(chunk, scanEnd, patterns[i]);
+                if (match != nullptr) {
+                    storeLowest(found[i], reinterpret_cast<uintptr_t>(match));
+                }
+            }
+
+            if (!anyLeft) {
+                return;
+            }
+        }
+    };
+
+    const size_t size = static_cast<size_t>(end - begin);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, maxThreads);
+    // Not worth a thread if each would get less than a few chunks.
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, size / (4 * chunkSize))));
+
+    if (threads == 1) {
+        scanRegion(begin, end);
+    }
+    else {
+        // Whole chunks per thread, so regions line up with the chunk grid.
+        const size_t regionSize = (size / threads + chunkSize - 1) / chunkSize * chunkSize;
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            const size_t offset = t * regionSize;
+            if (offset >= size) {
+                break;
+            }
+            const uint8_t* regionBegin = begin + offset;
+            const uint8_t* regionEnd = begin + std::min(size, offset + regionSize);
+            workers.emplace_back(scanRegion, regionBegin, regionEnd);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        uintptr_t address = found[i].load(std::memory_order_relaxed);
+        if (address != notFound) {
+            results[i] = reinterpret_cast<const uint8_t*>(address);
+        }
+    }
+    return results;
+}
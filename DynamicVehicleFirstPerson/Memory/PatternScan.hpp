@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Memory {
+    struct SPattern {
+        std::vector<uint8_t> Bytes;
+        // 0xFF: byte must match, 0x00: wildcard
+        std::vector<uint8_t> Mask;
+
+        // Indices of the two least common fixed bytes. Candidates are found by
+        // looking for these first, everything else is only checked on a hit.
+        size_t Anchor = 0;
+        size_t SecondAnchor = 0;
+    };
+
+    // "48 8B ? ?? 05", wildcards are ? or ??.
+    SPattern ParsePattern(const char* pattStr);
+    // Raw bytes with a mask of 'x' (match) and '?' (wildcard).
+    SPattern ParsePattern(const char* pattern, const char* mask);
+
+    // Returns the first (lowest) match in [begin, end), or nullptr.
+    // Portable, only needs SSE2, so it can be tested outside of the game.
+    const uint8_t* ScanPattern(const uint8_t* begin, const uint8_t* end, const SPattern& pattern);
+
+    // True if the pattern fully matches at address, and fits before end.
+    bool PatternMatches(const uint8_t* address, const uint8_t* end, const SPattern& pattern);
+
+    // Identifies a pattern (bytes and mask), e.g. as a cache key.
+    uint64_t PatternHash(const SPattern& pattern);
+
+    // Same as ScanPattern for each pattern, but walks [begin, end) only once.
+    // Patterns are bucketed by a few of their rarest fixed bytes, and one SSSE3
+    // sweep finds the candidates for all of them, so the cost barely grows with
+    // the pattern count. Without SSSE3 (or two fixed bytes in a row) patterns
+    // are scanned one by one. The range is split over threads (0: hardware
+    // concurrency).
+    std::vector<const uint8_t*> ScanPatterns(const uint8_t* begin, const uint8_t* end,
+        const std::vector<SPattern>& patterns, unsigned threads = 0);
+}
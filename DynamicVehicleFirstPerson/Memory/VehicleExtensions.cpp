@@ -2,6 +2,9 @@
 
 #include "MemoryAccess.hpp"
 #include "../Util/Logger.hpp"
+#include "../Util/Tracing.hpp"
+
+#include <algorithm>
 
 namespace {
     int hoverTransformRatioOffset = 0;
@@ -11,79 +14,91 @@ namespace {
 
     int wheelSuspensionCompressionOffset = 0;
     int wheelMatTypeOffset = 0;
+
+    // Last resolved entity. Only valid until the next InvalidateAddressCache,
+    // as the game may move or free the entity between ticks.
+    bool addressCached = false;
+    Vehicle cachedHandle = 0;
+    uintptr_t cachedAddress = 0;
+
+    uintptr_t getAddress(Vehicle handle) {
+        if (!addressCached || cachedHandle != handle) {
+            FPV_TRACE_ZONE("VExt: resolve address");
+            cachedHandle = handle;
+            cachedAddress = Memory::GetAddressOfEntity(handle);
+            addressCached = true;
+        }
+        return cachedAddress;
+    }
 }
 
 void VehicleExtensions::Init() {
     // alloc8or
-    auto addr = Memory::FindPattern("F3 0F 11 B3 ? ? ? ? 44 88 ? ? ? ? ? 48 85 C9");
-    hoverTransformRatioOffset = addr == 0 ? 0 : *(int*)(addr + 4);
-    LOG(hoverTransformRatioOffset == 0 ? WARN : DEBUG, "[VExt] Hover Transform Active offset: 0x{:03X}", hoverTransformRatioOffset);
-
-    addr = Memory::FindPattern("76 03 0F 28 F0 F3 44 0F 10 93");
-    rpmOffset = addr == 0 ? 0 : *(int*)(addr + 10);
-    LOG(rpmOffset == 0 ? WARN : DEBUG, "[VExt] RPM offset: 0x{:03X}", rpmOffset);
-
-    addr = Memory::FindPattern("3B B7 ? ? ? ? 7D 0D");
-    wheelsContainerOffset = addr == 0 ? 0 : *(int*)(addr + 2) - 8;
-    LOG(wheelsContainerOffset == 0 ? WARN : DEBUG, "[VExt] Wheels Container offset: 0x{:03X}", wheelsContainerOffset);
-
-    wheelCountOffset = addr == 0 ? 0 : *(int*)(addr + 2);
-    LOG(wheelCountOffset == 0 ? WARN : DEBUG, "[VExt] Wheel Count offset: 0x{:03X}", wheelCountOffset);
-
-    addr = Memory::FindPattern("45 0F 57 ? F3 0F 11 ? ? ? 00 00 F3 0F 5C");
-    wheelSuspensionCompressionOffset = addr == 0 ? 0 : *(int*)(addr + 8);
-    LOG(wheelSuspensionCompressionOffset == 0 ? WARN : DEBUG, "[VExt] Wheel Suspension Compression Offset: 0x%X", wheelSuspensionCompressionOffset);
+    Memory::AddPattern("F3 0F 11 B3 ? ? ? ? 44 88 ? ? ? ? ? 48 85 C9", [](uintptr_t addr) {
+        hoverTransformRatioOffset = addr == 0 ? 0 : *(int*)(addr + 4);
+        LOG(hoverTransformRatioOffset == 0 ? WARN : DEBUG, "[VExt] Hover Transform Active offset: 0x{:03X}", hoverTransformRatioOffset);
+    });
+
+    Memory::AddPattern("76 03 0F 28 F0 F3 44 0F 10 93", [](uintptr_t addr) {
+        rpmOffset = addr == 0 ? 0 : *(int*)(addr + 10);
+        LOG(rpmOffset == 0 ? WARN : DEBUG, "[VExt] RPM offset: 0x{:03X}", rpmOffset);
+    });
+
+    Memory::AddPattern("3B B7 ? ? ? ? 7D 0D", [](uintptr_t addr) {
+        wheelsContainerOffset = addr == 0 ? 0 : *(int*)(addr + 2) - 8;
+        LOG(wheelsContainerOffset == 0 ? WARN : DEBUG, "[VExt] Wheels Container offset: 0x{:03X}", wheelsContainerOffset);
+
+        wheelCountOffset = addr == 0 ? 0 : *(int*)(addr + 2);
+        LOG(wheelCountOffset == 0 ? WARN : DEBUG, "[VExt] Wheel Count offset: 0x{:03X}", wheelCountOffset);
+    });
+
+    Memory::AddPattern("45 0F 57 ? F3 0F 11 ? ? ? 00 00 F3 0F 5C", [](uintptr_t addr) {
+        wheelSuspensionCompressionOffset = addr == 0 ? 0 : *(int*)(addr + 8);
+        LOG(wheelSuspensionCompressionOffset == 0 ? WARN : DEBUG, "[VExt] Wheel Suspension Compression Offset: 0x%X", wheelSuspensionCompressionOffset);
+    });
+
+    Memory::AddPattern("88 8B ? ? 00 00 41 0F B6 47 51 66 89 83 ? ? 00 00", [](uintptr_t addr) {
+        wheelMatTypeOffset = addr == 0 ? 0 : (*(int*)(addr + 2));
+        LOG(wheelMatTypeOffset == 0 ? WARN : DEBUG, "Wheel Material Type offset: 0x{:03X}", wheelMatTypeOffset);
+    });
+}
 
-    addr = Memory::FindPattern("88 8B ? ? 00 00 41 0F B6 47 51 66 89 83 ? ? 00 00");
-    wheelMatTypeOffset = addr == 0 ? 0 : (*(int*)(addr + 2));
-    LOG(wheelMatTypeOffset == 0 ? WARN : DEBUG, "Wheel Material Type offset: 0x{:03X}", wheelMatTypeOffset);
+void VehicleExtensions::InvalidateAddressCache() {
+    addressCached = false;
+    cachedHandle = 0;
+    cachedAddress = 0;
 }
 
 float VehicleExtensions::GetHoverTransformRatio(Vehicle handle) {
     if (hoverTransformRatioOffset == 0) return {};
-    return *reinterpret_cast<float*>(Memory::GetAddressOfEntity(handle) + hoverTransformRatioOffset);
+    return *reinterpret_cast<float*>(getAddress(handle) + hoverTransformRatioOffset);
 }
 
 float VehicleExtensions::GetRPM(Vehicle handle) {
     if (rpmOffset == 0) return {};
-    return *reinterpret_cast<float*>(Memory::GetAddressOfEntity(handle) + rpmOffset);
+    return *reinterpret_cast<float*>(getAddress(handle) + rpmOffset);
 }
 
-uint64_t VehicleExtensions::GetWheelsPtr(Vehicle handle) {
-    if (wheelsContainerOffset == 0) return {};
-    return *reinterpret_cast<uint64_t*>(Memory::GetAddressOfEntity(handle) + wheelsContainerOffset);
-}
-
-uint8_t VehicleExtensions::GetNumWheels(Vehicle handle) {
-    if (wheelCountOffset == 0) return {};
-    return *reinterpret_cast<int*>(Memory::GetAddressOfEntity(handle) + wheelCountOffset);
-}
-
-std::vector<float> VehicleExtensions::GetSuspensionCompressions(Vehicle handle) {
-    if (wheelSuspensionCompressionOffset == 0) return {};
-    auto wheelPtr = GetWheelsPtr(handle);
-    if (wheelPtr == 0) return {};
+void VehicleExtensions::GetWheelData(Vehicle handle, SWheelData& wheels) {
+    FPV_TRACE_ZONE("VExt::GetWheelData");
+    wheels.Count = 0;
+    // Material 0 would match a DEFAULT reaction, so no materials means no wheels.
+    if (wheelsContainerOffset == 0 || wheelCountOffset == 0 || wheelMatTypeOffset == 0) return;
 
-    auto numWheels = GetNumWheels(handle);
-    std::vector<float> compressions(numWheels);
-    for (auto i = 0; i < numWheels; i++) {
-        auto wheelAddr = *reinterpret_cast<uint64_t*>(wheelPtr + 0x008 * i);
-        compressions[i] = *reinterpret_cast<float*>(wheelAddr + wheelSuspensionCompressionOffset);
-    }
-    return compressions;
-}
+    auto address = getAddress(handle);
+    if (address == 0) return;
 
-std::vector<uint16_t> VehicleExtensions::GetTireContactMaterials(Vehicle handle) {
-    if (wheelMatTypeOffset == 0) return {};
-    auto wheelPtr = GetWheelsPtr(handle);
-    if (wheelPtr == 0) return {};
+    auto wheelPtr = *reinterpret_cast<uint64_t*>(address + wheelsContainerOffset);
+    if (wheelPtr == 0) return;
 
-    auto numWheels = GetNumWheels(handle);
-    std::vector<uint16_t> values(numWheels);
+    int numWheels = *reinterpret_cast<int*>(address + wheelCountOffset);
+    wheels.Count = static_cast<uint8_t>(std::clamp(numWheels, 0, static_cast<int>(SWheelData::MaxWheels)));
 
-    for (auto i = 0; i < numWheels; i++) {
+    for (uint8_t i = 0; i < wheels.Count; i++) {
         auto wheelAddr = *reinterpret_cast<uint64_t*>(wheelPtr + 0x008 * i);
-        values[i] = (*reinterpret_cast<uint16_t*>(wheelAddr + wheelMatTypeOffset));
+        wheels.Compression[i] = wheelSuspensionCompressionOffset == 0 ? 0.0f :
+            *reinterpret_cast<float*>(wheelAddr + wheelSuspensionCompressionOffset);
+        wheels.Material[i] = *reinterpret_cast<uint16_t*>(wheelAddr + wheelMatTypeOffset);
+        wheels.OnGround[i] = wheels.Compression[i] > 0.0f;
     }
-    return values;
 }
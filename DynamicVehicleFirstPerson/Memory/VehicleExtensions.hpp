@@ -1,17 +1,24 @@
 #pragma once
+#include "WheelData.hpp"
+
 #include <inc/types.h>
 #include <cstdint>
-#include <vector>
 
 namespace VehicleExtensions {
+    // Registers patterns, offsets are known after Memory::ScanPatterns.
     void Init();
 
+    // The getters share one resolved entity address per handle.
+    // Call once per tick, and when the vehicle changes.
+    void InvalidateAddressCache();
+
     float GetHoverTransformRatio(Vehicle handle);
     float GetRPM(Vehicle handle);
-    uint64_t GetWheelsPtr(Vehicle handle);
-    uint8_t GetNumWheels(Vehicle handle);
-    std::vector<float> GetSuspensionCompressions(Vehicle handle);
-    std::vector<uint16_t> GetTireContactMaterials(Vehicle handle);
+
+    // Resolves the vehicle address once and reads every wheel.
+    // Count is 0 if the vehicle or the offsets aren't available, including the
+    // material offset, so terrain shake has nothing to react to.
+    void GetWheelData(Vehicle handle, SWheelData& wheels);
 }
 
 // harold_thumbs_up.webp
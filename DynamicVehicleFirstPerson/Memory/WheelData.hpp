@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+namespace VehicleExtensions {
+    // Per-wheel data, read in one go. Fixed size, so it can live on the stack
+    // or in a per-tick snapshot without allocating.
+    struct SWheelData {
+        static constexpr uint8_t MaxWheels = 16;
+
+        uint8_t Count = 0;
+        float Compression[MaxWheels]{};
+        uint16_t Material[MaxWheels]{};
+        // Suspension is compressed, so the wheel touches something
+        bool OnGround[MaxWheels]{};
+    };
+}
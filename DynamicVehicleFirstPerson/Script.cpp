@@ -1,10 +1,12 @@
 #include "Script.hpp"
 
 #include "ScriptMenu.hpp"
+#include "ConfigCache.hpp"
 #include "Memory/MemoryAccess.hpp"
 #include "Memory/VehicleExtensions.hpp"
 #include "MTCamCompatibility.hpp"
 
+#include "Util/AddonSpawnerCache.hpp"
 #include "Util/Logger.hpp"
 #include "Util/Paths.hpp"
 #include "Util/UI.hpp"
@@ -12,13 +14,33 @@
 
 #include <inc/main.h>
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <execution>
+#include <filesystem>
+#include <format>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace {
     std::shared_ptr<CFPVScript> coreScript;
     std::unique_ptr<CScriptMenu<CFPVScript>> scriptMenu;
     std::shared_ptr<CScriptSettings> settings;
     std::shared_ptr<CShakeData> shakeData;
+    CProfiler profiler;
+    CGameFrameClock frameClock;
+
+    // std::list, so reloading doesn't move configs the script points to.
+    std::list<CConfig> configs;
+    CConfigIndex configIndex;
 
-    std::vector<CConfig> configs;
+    using SConfigFile = CConfigCache::SFileInfo;
+    std::unique_ptr<CConfigCache> configCache;
+
+    // Last seen write time and size per config file, keyed by lowercase path.
+    std::unordered_map<std::string, SConfigFile> configFiles;
 
     bool initialized = false;
 }
@@ -26,8 +48,15 @@ namespace {
 namespace FPV {
     void scriptInit();
     void scriptTick();
+    void showProfiler();
 
     void updateActiveConfigs();
+
+    std::vector<SConfigFile> findConfigFiles();
+    std::vector<CConfig> readConfigHeaders(const std::vector<SConfigFile>& files);
+    void rememberConfigFile(const std::string& path);
+    void finishLoadConfigs(std::chrono::steady_clock::time_point loadStart);
+    void updateConfigCache();
 }
 
 void FPV::ScriptMain() {
@@ -58,12 +87,14 @@ void FPV::scriptInit() {
     LOG(INFO, "Game version: {}", static_cast<int>(getGameVersion()));
     Memory::Init();
     VehicleExtensions::Init();
+    Memory::ScanPatterns(Paths::GetModPath() / "signatures.cache");
     Compatibility::Setup();
     Compatibility::DisableMTCam();
 
+    configCache = std::make_unique<CConfigCache>(Paths::GetModPath() / "Configs" / ".cache");
     LoadConfigs();
 
-    coreScript = std::make_shared<CFPVScript>(settings, shakeData, configs);
+    coreScript = std::make_shared<CFPVScript>(settings, shakeData, configs, configIndex, profiler, frameClock);
     coreScript->UpdateActiveConfig();
 
     // The menu being initialized. Note the passed settings,
@@ -73,7 +104,7 @@ void FPV::scriptInit() {
             // onInit
             settings->Load();
             shakeData->Load();
-            LoadConfigs();
+            ReloadConfigs();
         },
         []() {
             settings->Save();
@@ -86,12 +117,38 @@ void FPV::scriptInit() {
 
 void FPV::scriptTick() {
     while (true) {
-        coreScript->Tick();
-        scriptMenu->Tick(*coreScript);
+        profiler.SetEnabled(settings->Debug.Enable && settings->Debug.Profiler);
+        profiler.BeginFrame();
+
+        frameClock.Tick();
+        VehicleExtensions::InvalidateAddressCache();
+        {
+            CProfiler::CScope profile(&profiler, EProfileStage::ScriptTick);
+            coreScript->Tick();
+        }
+        {
+            CProfiler::CScope profile(&profiler, EProfileStage::MenuTick);
+            scriptMenu->Tick(*coreScript);
+        }
+
+        if (profiler.Enabled()) {
+            showProfiler();
+        }
         WAIT(0);
     }
 }
 
+void FPV::showProfiler() {
+    UI::ShowText(0.01f, 0.30f, 0.3f, "Stage: min / avg / p99 / max (us)");
+    for (size_t i = 0; i < CProfiler::StageCount; ++i) {
+        auto stage = static_cast<EProfileStage>(i);
+        auto stats = profiler.Stats(stage);
+        UI::ShowText(0.01f, 0.32f + 0.02f * static_cast<float>(i), 0.3f,
+            std::format("{}: {:.1f} / {:.1f} / {:.1f} / {:.1f}",
+                CProfiler::StageName(stage), stats.Min, stats.Avg, stats.P99, stats.Max));
+    }
+}
+
 void FPV::updateActiveConfigs() {
     if (coreScript) {
         coreScript->UpdateActiveConfig();
@@ -110,61 +167,251 @@ CFPVScript& FPV::GetScript() {
     return *coreScript;
 }
 
-const std::vector<CConfig>& FPV::GetConfigs() {
+CProfiler& FPV::GetProfiler() {
+    return profiler;
+}
+
+const std::list<CConfig>& FPV::GetConfigs() {
     return configs;
 }
 
-uint32_t FPV::LoadConfigs() {
+std::vector<SConfigFile> FPV::findConfigFiles() {
     namespace fs = std::filesystem;
 
     const auto configsPath = Paths::GetModPath() / "Configs";
 
-    LOG(DEBUG, "Reloading configs");
-
-    configs.clear();
-
     if (!(fs::exists(configsPath) && fs::is_directory(configsPath))) {
         LOG(WARN, "Directory [{}] not found!", configsPath.string());
         fs::create_directories(configsPath);
     }
 
+    std::vector<SConfigFile> files;
     for (const auto& file : fs::directory_iterator(configsPath)) {
-        if (StrUtil::ToLower(fs::path(file).extension().string()) != ".ini") {
+        if (StrUtil::ToLower(file.path().extension().string()) != ".ini") {
             LOG(DEBUG, "Skipping [{}] - not .ini", file.path().stem().string());
             continue;
         }
 
-        CConfig config = CConfig::Read(fs::path(file).string());
-        if (config.Name.empty()) {
-            continue;
-        }
-        if (StrUtil::Strcmpwi(config.Name, "Default")) {
-            configs.insert(configs.begin(), config);
-            continue;
-        }
+        std::error_code ec;
+        SConfigFile configFile{
+            .Path = file.path().string(),
+            .WriteTime = file.last_write_time(ec).time_since_epoch().count(),
+            .Size = file.file_size(ec),
+        };
+        files.push_back(configFile);
+    }
+    return files;
+}
 
-        configs.push_back(config);
-        LOG(DEBUG, "Loaded vehicle config [{}]", config.Name);
+std::vector<CConfig> FPV::readConfigHeaders(const std::vector<SConfigFile>& files) {
+    // Worker threads must only read the cache, so fill it here.
+    ASCache::Get();
+
+    // Only [ID] is read here, the rest is loaded when a config gets used.
+    std::vector<CConfig> headers(files.size());
+    std::transform(std::execution::par, files.begin(), files.end(), headers.begin(),
+        [](const SConfigFile& file) {
+            return CConfig::ReadHeader(file.Path);
+        });
+    return headers;
+}
+
+void FPV::rememberConfigFile(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    SConfigFile configFile{
+        .Path = path,
+        .WriteTime = fs::last_write_time(path, ec).time_since_epoch().count(),
+        .Size = fs::file_size(path, ec),
+    };
+    if (!ec) {
+        configFiles[StrUtil::ToLower(path)] = configFile;
     }
+}
 
-    if (configs.empty() ||
-        !configs.empty() && !StrUtil::Strcmpwi(configs[0].Name, "Default")) {
+void FPV::finishLoadConfigs(std::chrono::steady_clock::time_point loadStart) {
+    // Keep the directory order (alphabetical) regardless of when a config was added,
+    // as the first config for a vehicle wins. Sorting a list doesn't move the configs.
+    configs.sort([](const CConfig& a, const CConfig& b) {
+        return std::lexicographical_compare(a.Name.begin(), a.Name.end(), b.Name.begin(), b.Name.end(),
+            [](char c1, char c2) {
+                return std::tolower(static_cast<unsigned char>(c1)) < std::tolower(static_cast<unsigned char>(c2));
+            });
+    });
+
+    auto defaultConfig = std::find_if(configs.begin(), configs.end(), [](const CConfig& config) {
+        return StrUtil::Strcmpwi(config.Name, "Default");
+    });
+
+    if (defaultConfig != configs.end()) {
+        configs.splice(configs.begin(), configs, defaultConfig);
+    }
+    else {
         LOG(WARN, "No default config found, generating a default one and saving it...");
-        CConfig defaultConfig{};
-        defaultConfig.Name = "Default";
+        CConfig& newDefault = configs.emplace_front();
+        newDefault.Name = "Default";
 
-        defaultConfig.Mount.push_back(CConfig::SCameraSettings{
+        newDefault.Mount.push_back(CConfig::SCameraSettings{
                 .Name = "Default",
                 .Order = 0
             }
         );
-        configs.insert(configs.begin(), defaultConfig);
-        defaultConfig.Write(CConfig::ESaveType::GenericNone);
+        newDefault.Write(CConfig::ESaveType::GenericNone);
+        rememberConfigFile(newDefault.Path());
     }
 
-    LOG(INFO, "Configs loaded: {}", configs.size());
+    const auto loadTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - loadStart);
+    LOG(INFO, "Configs loaded: {} ({:.2f} ms)", configs.size(), loadTime.count() / 1000.0);
+
+    configIndex.Build(configs);
 
     FPV::updateActiveConfigs();
+    updateConfigCache();
+}
+
+void FPV::updateConfigCache() {
+    if (!configCache) {
+        return;
+    }
+
+    // Unsaved edits don't belong in the cache, those configs are read from the .ini next time.
+    std::vector<CConfigCache::SSource> sources;
+    for (const auto& config : configs) {
+        if (config.Dirty || config.Path().empty()) {
+            continue;
+        }
+        auto file = configFiles.find(StrUtil::ToLower(config.Path()));
+        if (file == configFiles.end()) {
+            continue;
+        }
+        sources.push_back({ file->second, &config });
+    }
+
+    if (!configCache->Matches(sources)) {
+        configCache->Save(sources);
+    }
+}
+
+uint32_t FPV::LoadConfigs() {
+    LOG(DEBUG, "Reloading configs");
+
+    const auto loadStart = std::chrono::steady_clock::now();
+
+    configIndex.Clear();
+    configs.clear();
+    configFiles.clear();
+
+    const auto files = findConfigFiles();
+
+    // Unchanged files come from the cache, the rest from their .ini.
+    const bool cacheLoaded = configCache && configCache->Load();
+    std::vector<SConfigFile> uncachedFiles;
+    for (const auto& file : files) {
+        CConfig cached;
+        if (!cacheLoaded || !configCache->Find(file, cached)) {
+            uncachedFiles.push_back(file);
+            continue;
+        }
+        configs.push_back(std::move(cached));
+        configFiles[StrUtil::ToLower(file.Path)] = file;
+    }
+
+    LOG(DEBUG, "Configs: {} cached, {} to read", configs.size(), uncachedFiles.size());
+
+    auto headers = readConfigHeaders(uncachedFiles);
+
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (headers[i].Name.empty()) {
+            LOG(ERROR, "Failed to read [{}]", uncachedFiles[i].Path);
+            continue;
+        }
+
+        configs.push_back(std::move(headers[i]));
+        configFiles[StrUtil::ToLower(uncachedFiles[i].Path)] = uncachedFiles[i];
+    }
+
+    finishLoadConfigs(loadStart);
+    return static_cast<unsigned>(configs.size());
+}
+
+uint32_t FPV::ReloadConfigs() {
+    if (configs.empty()) {
+        return LoadConfigs();
+    }
+
+    LOG(DEBUG, "Reloading changed configs");
+
+    const auto loadStart = std::chrono::steady_clock::now();
+
+    const auto files = findConfigFiles();
+
+    std::unordered_map<std::string, CConfig*> configsByPath;
+    for (auto& config : configs) {
+        if (!config.Path().empty()) {
+            configsByPath.emplace(StrUtil::ToLower(config.Path()), &config);
+        }
+    }
+
+    std::unordered_set<std::string> seenPaths;
+    std::vector<SConfigFile> changedFiles;
+    for (const auto& file : files) {
+        std::string key = StrUtil::ToLower(file.Path);
+        auto known = configFiles.find(key);
+        if (known == configFiles.end() ||
+            known->second.WriteTime != file.WriteTime ||
+            known->second.Size != file.Size) {
+            changedFiles.push_back(file);
+        }
+        seenPaths.insert(std::move(key));
+    }
+
+    uint32_t removed = static_cast<uint32_t>(std::erase_if(configs, [&](const CConfig& config) {
+        return !config.Path().empty() && !seenPaths.contains(StrUtil::ToLower(config.Path()));
+    }));
+    std::erase_if(configFiles, [&](const auto& entry) {
+        return !seenPaths.contains(entry.first);
+    });
+
+    uint32_t added = 0;
+    uint32_t changed = 0;
+    auto headers = readConfigHeaders(changedFiles);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        const std::string key = StrUtil::ToLower(changedFiles[i].Path);
+        auto existing = configsByPath.find(key);
+
+        if (headers[i].Name.empty()) {
+            LOG(ERROR, "Failed to read [{}]", changedFiles[i].Path);
+            if (existing != configsByPath.end()) {
+                const CConfig* stale = existing->second;
+                std::erase_if(configs, [stale](const CConfig& config) { return &config == stale; });
+                ++removed;
+            }
+            configFiles.erase(key);
+            continue;
+        }
+
+        if (existing != configsByPath.end()) {
+            // Assign in place, so pointers to this config stay valid.
+            CConfig& config = *existing->second;
+            bool wasLoaded = config.IsLoaded();
+            config = std::move(headers[i]);
+            if (wasLoaded) {
+                config.EnsureLoaded();
+            }
+            ++changed;
+        }
+        else {
+            configs.push_back(std::move(headers[i]));
+            ++added;
+        }
+        configFiles[key] = changedFiles[i];
+    }
+
+    LOG(INFO, "Configs reloaded: {} added, {} changed, {} removed", added, changed, removed);
+
+    finishLoadConfigs(loadStart);
     return static_cast<unsigned>(configs.size());
 }
 
@@ -173,14 +420,21 @@ void FPV::SaveConfigs() {
 
     const auto configsPath = Paths::GetModPath() / "Configs";
 
-    LOG(DEBUG, "Saving all configs");
+    LOG(DEBUG, "Saving changed configs");
 
     if (!(fs::exists(configsPath) && fs::is_directory(configsPath))) {
         LOG(ERROR, "Directory [{}] not found!", configsPath.string());
         return;
     }
 
+    uint32_t written = 0;
+    std::vector<std::string> failed;
     for (auto& config : configs) {
+        // Configs that were never loaded can't have been edited either.
+        if (!config.Dirty || !config.IsLoaded()) {
+            continue;
+        }
+
         CConfig::ESaveType saveType;
         if (config.Name == "Default") {
             saveType = CConfig::ESaveType::GenericNone;
@@ -192,6 +446,21 @@ void FPV::SaveConfigs() {
             saveType = CConfig::ESaveType::Specific;
         }
 
-        config.Write(saveType);
+        // Stays dirty if this fails, so the next save tries again.
+        if (!config.Write(saveType)) {
+            failed.push_back(config.Name);
+            continue;
+        }
+        // Don't pick up our own writes as changes on the next reload.
+        rememberConfigFile(config.Path());
+        ++written;
+    }
+
+    LOG(INFO, "Configs saved: {} file(s) written", written);
+    if (!failed.empty()) {
+        LOG(ERROR, "Configs not saved: {}", StrUtil::Join(failed, ", ", "{}"));
     }
+
+    // Also picks up configs that were fully loaded since the last save.
+    updateConfigCache();
 }
@@ -3,6 +3,8 @@
 #include "ScriptMenu.hpp"
 #include "ShakeData.hpp"
 
+#include <list>
+
 namespace FPV {
     void ScriptMain();
     std::vector<CScriptMenu<CFPVScript>::CSubmenu> BuildMenu();
@@ -10,8 +12,12 @@ namespace FPV {
     CScriptSettings& GetSettings();
     CShakeData& GetShakeData();
     CFPVScript& GetScript();
-    const std::vector<CConfig>& GetConfigs();
+    CProfiler& GetProfiler();
+    const std::list<CConfig>& GetConfigs();
 
     uint32_t LoadConfigs();
+    // Only re-reads configs whose file changed, and adds/removes configs
+    // for created/deleted files. Existing CConfig objects stay in place.
+    uint32_t ReloadConfigs();
     void SaveConfigs();
 }
@@ -42,6 +42,8 @@ void CScriptSettings::Load() {
     LOAD_VAL("Debug.DoF", "NearInFocus", Debug.DoF.NearInFocus);
     LOAD_VAL("Debug.DoF", "FarInFocus", Debug.DoF.FarInFocus);
     LOAD_VAL("Debug.DoF", "FarOutFocus", Debug.DoF.FarOutFocus);
+
+    LOAD_VAL("Debug", "Profiler", Debug.Profiler);
 }
 
 void CScriptSettings::Save() {
@@ -66,6 +68,8 @@ void CScriptSettings::Save() {
         SAVE_VAL("Debug.DoF", "NearInFocus", Debug.DoF.NearInFocus);
         SAVE_VAL("Debug.DoF", "FarInFocus", Debug.DoF.FarInFocus);
         SAVE_VAL("Debug.DoF", "FarOutFocus", Debug.DoF.FarOutFocus);
+
+        SAVE_VAL("Debug", "Profiler", Debug.Profiler);
     }
 
     result = ini.SaveFile(mSettingsFile.c_str());
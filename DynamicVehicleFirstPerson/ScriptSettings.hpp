@@ -31,6 +31,9 @@ public:
             float FarInFocus = 5000.0f;
             float FarOutFocus = 100000.0f;
         } DoF;
+
+        // Frame time overlay for the script tick
+        bool Profiler = false;
     } Debug;
 
 private:
@@ -30,7 +30,7 @@ void CShakeData::Load() {
     LOAD_VAL("BaseRates", "MinRateModTrn", MinRateModTrn);
     LOAD_VAL("BaseRates", "MaxRateModTrn", MaxRateModTrn);
 
-    MaterialReactionMap.clear();
+    std::vector<SMaterialReaction> reactions;
     for (uint32_t i = 0; i < sMaterialNames.size(); ++i) {
         if (ini.KeyExists("MaterialReaction", sMaterialNames[i])) {
             auto line = ini.GetValue("MaterialReaction", sMaterialNames[i]);
@@ -40,7 +40,8 @@ void CShakeData::Load() {
                 LOG(ERROR, "[Shake] Failed to process line: '{}'", line);
                 continue;
             }
-            MaterialReactionMap.insert({ static_cast<eMaterial>(i), { amplitude, frequency } });
+            reactions.push_back({ static_cast<eMaterial>(i), { amplitude, frequency } });
         }
     }
+    SetMaterialReactions(std::move(reactions));
 }
@@ -1,28 +1,73 @@
 #pragma once
 #include "Util/Enums.hpp"
 
-#include <map>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 struct SShakeParams {
     float Amplitude;
     float Frequency;
 };
 
+struct SMaterialReaction {
+    eMaterial Material;
+    SShakeParams Params;
+};
+
 class CShakeData {
 public:
+    CShakeData() = default;
     CShakeData(const std::string& shakeFile);
 
     void Load();
 
+    // Replaces the defined reactions and rebuilds the lookup.
+    // Reactions that don't fit the lookup table are dropped.
+    void SetMaterialReactions(std::vector<SMaterialReaction> reactions) {
+        mMaterialReactions.clear();
+        mMaterialLookup.fill({});
+        for (const auto& reaction : reactions) {
+            auto material = static_cast<size_t>(reaction.Material);
+            if (material >= mMaterialLookup.size()) {
+                continue;
+            }
+            mMaterialLookup[material] = { reaction.Params, true };
+            mMaterialReactions.push_back(reaction);
+        }
+    }
+
+    // nullptr if the material has no reaction defined.
+    const SShakeParams* FindMaterialReaction(uint16_t material) const {
+        if (material >= mMaterialLookup.size() || !mMaterialLookup[material].Defined) {
+            return nullptr;
+        }
+        return &mMaterialLookup[material].Params;
+    }
+
+    // Defined reactions, in material order.
+    const std::vector<SMaterialReaction>& MaterialReactions() const {
+        return mMaterialReactions;
+    }
+
     // Base rates
     float MinRateModSpd = 25.0f;
     float MaxRateModSpd = 50.0f;
     float MinRateModTrn = 12.0f;
     float MaxRateModTrn = 24.0f;
 
-    std::map<eMaterial, SShakeParams> MaterialReactionMap;
-
 private:
+    struct SLookupEntry {
+        SShakeParams Params{};
+        bool Defined = false;
+    };
+
     std::string mShakeFile;
+
+    std::vector<SMaterialReaction> mMaterialReactions;
+
+    // Indexed by material id, with the parameters inline,
+    // so the lookup per wheel is a single indexed load.
+    alignas(64) std::array<SLookupEntry, 256> mMaterialLookup{};
 };
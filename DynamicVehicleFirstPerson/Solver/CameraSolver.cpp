@@ -0,0 +1,679 @@
+#include "CameraSolver.hpp"
+
+#include "../Util/Math.hpp"
+
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+    constexpr float sRearAngleFree = 179.0f;
+    constexpr float sRearAngleBlocked = 135.0f;
+
+    // log2 of the fixed smoothing constants
+    const float sLog2Inertia = std::log2(0.000001f);
+    const float sLog2DoF = std::log2(0.01f);
+    const float sLog2Of10 = std::log2(10.0f);
+
+    // 1 - k^dt, with log2k = log2(k)
+    // A look time of 0 gives log2k = -inf, and -inf * 0 is NaN, so a frame
+    // without time (paused) returns 0 directly, like 1 - pow(k, 0) did.
+    float lerpFactor(float log2k, float frameTime) {
+        if (!(frameTime > 0.0f)) {
+            return 0.0f;
+        }
+        return 1.0f - FastExp2(log2k * frameTime);
+    }
+
+    // a where mask is set, b elsewhere
+    __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Inertia parameters, one lane per EInertiaLane
+    struct SInertiaLanes {
+        __m128 Deadzone;
+        // What map() starts from below -Deadzone. Lateral starts from +Deadzone
+        // on both sides, like the scalar code did.
+        __m128 NegativeEdge;
+        // Sign included, for g-forces above Deadzone and below -Deadzone
+        __m128 PositiveMult;
+        __m128 NegativeMult;
+        __m128 Min;
+        __m128 Max;
+    };
+
+    // Built in registers every frame: the menu edits the settings in place,
+    // and comparing them against a cached copy costs more than this.
+    SInertiaLanes packInertia(const CConfig::SMovement& m) {
+        return {
+            _mm_setr_ps(m.LatDeadzone, m.LongDeadzone, m.VertDeadzone, m.PitchDeadzone),
+            _mm_setr_ps(m.LatDeadzone, -m.LongDeadzone, -m.VertDeadzone, -m.PitchDeadzone),
+            // Accelerating pushes the camera back, going up pushes it down
+            _mm_setr_ps(m.LatMult, -m.LongBackwardMult, -m.VertDownMult, m.PitchUpMult),
+            _mm_setr_ps(m.LatMult, -m.LongForwardMult, -m.VertUpMult, m.PitchDownMult),
+            _mm_setr_ps(-m.LatLimit, -m.LongBackwardLimit, -m.VertDownLimit, -m.PitchDownMaxAngle),
+            _mm_setr_ps(m.LatLimit, m.LongForwardLimit, m.VertUpLimit, m.PitchUpMaxAngle),
+        };
+    }
+}
+
+CCameraSolver::CCameraSolver()
+    // Side, vertical and roll z offsets
+    : mShakeNoise(3.3f, 4.2f, 6.9f) {
+}
+
+void CCameraSolver::Reset() {
+    mRotation = {};
+    mLookAcc = {};
+
+    mInertiaDirectionLookAngle = 0.0f;
+    std::fill(std::begin(mInertia), std::end(mInertia), 0.0f);
+    mDynamicPitch = 0.0f;
+
+    mAverageAccel = 0.0f;
+}
+
+void CCameraSolver::ResetShake() {
+    mCumTimeSpeed = 0.0;
+    mCumTimeTerrain = 0.0;
+}
+
+SCameraSolverOutput CCameraSolver::Solve(const SCameraSolverInput& input) {
+    SCameraSolverOutput output;
+    if (!input.Camera || !input.Look) {
+        return output;
+    }
+
+    const auto& mount = *input.Camera;
+    updateSmoothing(input);
+
+    bool lookingIntoGlass = false;
+    switch (input.LookInput) {
+        case ELookInput::Wheel:
+            updateWheelLook(input, lookingIntoGlass);
+            break;
+        case ELookInput::Mouse:
+            updateMouseLook(input, lookingIntoGlass);
+            break;
+        case ELookInput::Controller:
+        default:
+            updateControllerLook(input, lookingIntoGlass);
+            break;
+    }
+
+    if (mount.Movement.Follow) {
+        CProfiler::CScope profile(mProfiler, EProfileStage::Inertia);
+        updateRotationCameraMovement(input);
+        updateInertia(input);
+    }
+
+    if (mount.DoF.Enable) {
+        CProfiler::CScope profile(mProfiler, EProfileStage::DoF);
+        updateDoF(input, output);
+    }
+
+    SVector3 leanOffset = getLeanOffset(input, lookingIntoGlass);
+
+    SVector3 shakeInfo{};
+    if (input.ShakeData) {
+        CProfiler::CScope profile(mProfiler, EProfileStage::Shake);
+        if (mount.Movement.ShakeSpeed > 0.0f) {
+            shakeInfo = getShakeFromSpeed(input);
+        }
+
+        if (mount.Movement.ShakeTerrain > 0.0f) {
+            shakeInfo = shakeInfo + getShakeFromTerrain(input);
+        }
+    }
+
+    output.Offset = {
+        mount.OffsetSide + leanOffset.x + mInertia[Lateral] + shakeInfo.x,
+        mount.OffsetForward + leanOffset.y + mInertia[Longitudinal],
+        mount.OffsetHeight + leanOffset.z + mInertia[Vertical] + shakeInfo.y
+    };
+
+    const SVector3& rot = input.Rotation;
+    SVector3 horizonLockRotation = getHorizonLockRotation(input);
+
+    float rollPitchComp = std::sin(deg2rad(mRotation.z)) * rot.y;
+    float pitchLookComp = 0.0f;
+    float rollLookComp = 0.0f;
+    if (!mount.HorizonLock.Lock) {
+        pitchLookComp = -rot.x * 2.0f * std::abs(mRotation.z) / 180.0f;
+        rollLookComp = -rot.y * 2.0f * std::abs(mRotation.z) / 180.0f;
+    }
+
+    output.Rotation = {
+        rot.x + mRotation.x + mount.Pitch + pitchLookComp + rollPitchComp + mInertia[Pitch] - horizonLockRotation.x,
+        rot.y + rollLookComp + horizonLockRotation.y + shakeInfo.z,
+        rot.z + mRotation.z - mInertiaDirectionLookAngle
+    };
+
+    output.FOV = mount.FOV;
+
+    float minimapAngle = rot.z + mRotation.z - mInertiaDirectionLookAngle;
+    if (minimapAngle > 360.0f) minimapAngle = minimapAngle - 360.0f;
+    if (minimapAngle < 0.0f) minimapAngle = minimapAngle + 360.0f;
+    output.MinimapAngle = minimapAngle;
+
+    return output;
+}
+
+void CCameraSolver::updateSmoothing(const SCameraSolverInput& input) {
+    const CConfig::SLook& look = *input.Look;
+    const float roughness = input.Camera->Movement.Roughness;
+    auto& s = mSmoothing;
+
+    const bool settingsChanged = look.LookTime != s.LookTime ||
+        look.MouseLookTime != s.MouseLookTime ||
+        roughness != s.Roughness;
+
+    if (!settingsChanged && input.FrameTime == s.FrameTime) {
+        return;
+    }
+
+    if (settingsChanged) {
+        s.LookTime = look.LookTime;
+        s.MouseLookTime = look.MouseLookTime;
+        s.Roughness = roughness;
+        // 0 (no smoothing) is -inf, which FastExp2 clamps. Negative would be NaN.
+        s.Log2LookTime = std::log2(std::max(look.LookTime, 0.0f));
+        s.Log2MouseLookTime = std::log2(std::max(look.MouseLookTime, 0.0f));
+        // Movement smoothing constant is 10^(-3 - Roughness)
+        s.Log2Roughness = (-3.0f - roughness) * sLog2Of10;
+    }
+
+    s.FrameTime = input.FrameTime;
+    s.Look = lerpFactor(s.Log2LookTime, input.FrameTime);
+    s.MouseLook = lerpFactor(s.Log2MouseLookTime, input.FrameTime);
+    s.Inertia = lerpFactor(sLog2Inertia, input.FrameTime);
+    s.Movement = lerpFactor(s.Log2Roughness, input.FrameTime);
+    s.DoF = lerpFactor(sLog2DoF, input.FrameTime);
+}
+
+// We generally want to look back through the center of the car, but follow the direction we already look into.
+// If centered (motorcycle), look back over right shoulder only if already looking right.
+// Otherwise, look back over left shoulder by default, as we usually drive on the right.
+float CCameraSolver::getRearLookAngle(ESeatPosition seatPosition, float lookLeftRight, float maxAngle) const {
+    // No pre-existing input: Follow seat position
+    if (std::abs(lookLeftRight) < 0.05f) {
+        if (seatPosition == ESeatPosition::Left) {
+            return -maxAngle;
+        }
+        else if (seatPosition == ESeatPosition::Right) {
+            return maxAngle;
+        }
+    }
+
+    // Pre-existing input: Follow existing looking direction.
+    // This is also the default for motorcycles/centered seats.
+    if (lookLeftRight >= 0.05f) {
+        return -maxAngle;
+    }
+    else {
+        return maxAngle;
+    }
+}
+
+void CCameraSolver::updateControllerLook(const SCameraSolverInput& input, bool& lookingIntoGlass) {
+    float lookLeftRight = input.LookLeftRight;
+    float lookUpDown = input.LookUpDown;
+
+    auto seatPosition = input.SeatPosition;
+    if (seatPosition != ESeatPosition::Center &&
+        input.DriverWindowPresent) {
+        if (seatPosition == ESeatPosition::Right && lookLeftRight > 0.01f) {
+            lookingIntoGlass = true;
+        }
+        if (seatPosition == ESeatPosition::Left && lookLeftRight < -0.01f) {
+            lookingIntoGlass = true;
+        }
+    }
+
+    const float maxAngle = lookingIntoGlass ? sRearAngleBlocked : sRearAngleFree;
+
+    if (lookingIntoGlass) {
+        if (std::abs(lookLeftRight * sRearAngleFree) > maxAngle) {
+            lookLeftRight = sgn(lookLeftRight) * (maxAngle / sRearAngleFree);
+        }
+    }
+
+    const float lerpFactor = mSmoothing.Look;
+    mRotation.x = lerp(mRotation.x, 90.0f * -lookUpDown, lerpFactor);
+
+    if (input.LookBehind) {
+        float lookBackAngle = getRearLookAngle(seatPosition, lookLeftRight, maxAngle);
+        mRotation.z = lerp(mRotation.z, lookBackAngle, lerpFactor);
+    }
+    else {
+        // Manual look
+        mRotation.z = lerp(mRotation.z, sRearAngleFree * -lookLeftRight, lerpFactor);
+    }
+}
+
+void CCameraSolver::updateMouseLook(const SCameraSolverInput& input, bool& lookingIntoGlass) {
+    float lookLeftRight = input.LookLeftRight * input.Look->MouseSensitivity;
+    float lookUpDown = input.LookUpDown * input.Look->MouseSensitivity;
+    bool lookBehind = input.LookBehind;
+
+    auto seatPosition = input.SeatPosition;
+    if (seatPosition != ESeatPosition::Center &&
+        input.DriverWindowPresent) {
+        if (seatPosition == ESeatPosition::Right && mLookAcc.x > 0.01f) {
+            lookingIntoGlass = true;
+        }
+        if (seatPosition == ESeatPosition::Left && mLookAcc.x < -0.01f) {
+            lookingIntoGlass = true;
+        }
+    }
+
+    const float maxAngle = lookingIntoGlass ? sRearAngleBlocked : sRearAngleFree;
+
+    // Re-center on no input
+    if (lookLeftRight != 0.0f || lookUpDown != 0.0f) {
+        mLookIdleTime = 0.0f;
+    }
+    else {
+        mLookIdleTime += input.FrameTime;
+    }
+    const bool lookIdle = mLookIdleTime * 1000.0f > static_cast<float>(input.Look->MouseCenterTimeout);
+
+    const float lerpFactor = mSmoothing.MouseLook;
+
+    float speed = input.Speed;
+    if (lookIdle && speed > 1.0f && !lookBehind) {
+        mLookAcc.y = lerp(mLookAcc.y, 0.0f, lerpFactor);
+        mLookAcc.x = lerp(mLookAcc.x, 0.0f, lerpFactor);
+    }
+    else {
+        mLookAcc.y += lookUpDown;
+
+        if (lookingIntoGlass) {
+            if (sgn(lookLeftRight) != sgn(mLookAcc.x) || std::abs(mRotation.z) + std::abs(lookLeftRight * sRearAngleFree) < maxAngle) {
+                mLookAcc.x += lookLeftRight;
+            }
+
+            if (std::abs(mLookAcc.x * sRearAngleFree) > maxAngle) {
+                mLookAcc.x = sgn(mLookAcc.x) * (maxAngle / sRearAngleFree);
+            }
+        }
+        else {
+            mLookAcc.x += lookLeftRight;
+        }
+
+        mLookAcc.y = std::clamp(mLookAcc.y, -1.0f, 1.0f);
+        mLookAcc.x = std::clamp(mLookAcc.x, -1.0f, 1.0f);
+    }
+
+    mRotation.x = lerp(mRotation.x, 90 * -mLookAcc.y, lerpFactor);
+
+    // Override any mRotation.z changes while looking back
+    if (lookBehind) {
+        float lookBackAngle = getRearLookAngle(seatPosition, -mRotation.z, maxAngle);
+        mRotation.z = lerp(mRotation.z, lookBackAngle, lerpFactor);
+    }
+    else {
+        mRotation.z = lerp(mRotation.z, sRearAngleFree * -mLookAcc.x, lerpFactor);
+    }
+}
+
+void CCameraSolver::updateWheelLook(const SCameraSolverInput& input, bool& lookingIntoGlass) {
+    const bool lookingLeft = input.MTLookLeft;
+    const bool lookingRight = input.MTLookRight;
+
+    if ((mMTLookRightPrev && lookingRight) &&
+        (!mMTLookLeftPrev && lookingLeft)) {
+        // LookRight was pressed already, and LookLeft was just pressed
+        mMTLookBackRightShoulder = true;
+    }
+    if (!lookingLeft ||
+        !lookingRight) {
+        // Any button released, stop caring about this
+        mMTLookBackRightShoulder = false;
+    }
+
+    const float lerpFactor = mSmoothing.MouseLook;
+
+    if ((lookingLeft && lookingRight) || input.MTLookBack) {
+        auto seatPosition = input.SeatPosition;
+        if (input.DriverWindowPresent) {
+            if (seatPosition == ESeatPosition::Right && mMTLookBackRightShoulder) {
+                lookingIntoGlass = true;
+            }
+            if (seatPosition == ESeatPosition::Left && !mMTLookBackRightShoulder) {
+                lookingIntoGlass = true;
+            }
+        }
+
+        const float maxAngle = lookingIntoGlass ? sRearAngleBlocked : sRearAngleFree;
+        float lookBackAngle = mMTLookBackRightShoulder ? -maxAngle : maxAngle;
+        mRotation.z = lerp(mRotation.z, lookBackAngle, lerpFactor);
+    }
+    else {
+        float angle;
+        if (lookingLeft) {
+            angle = 90.0f;
+        }
+        else {
+            angle = -90.0f;
+        }
+        mRotation.z = lerp(mRotation.z, angle, lerpFactor);
+    }
+
+    mMTLookLeftPrev = lookingLeft;
+    mMTLookRightPrev = lookingRight;
+}
+
+void CCameraSolver::updateRotationCameraMovement(const SCameraSolverInput& input) {
+    const auto& movement = input.Camera->Movement;
+    const SVector3& speedVector = input.SpeedVector;
+
+    SVector3 target = Normalize(speedVector);
+    float travelDir = std::atan2(target.y, target.x) - static_cast<float>(M_PI) / 2.0f;
+    if (travelDir > static_cast<float>(M_PI) / 2.0f) {
+        travelDir -= static_cast<float>(M_PI);
+    }
+    if (travelDir < -static_cast<float>(M_PI) / 2.0f) {
+        travelDir += static_cast<float>(M_PI);
+    }
+
+    const SVector3& rotationVelocity = input.RotationVelocity;
+
+    float velComponent = travelDir * movement.RotationDirectionMult;
+    float rotComponent = rotationVelocity.z * movement.RotationRotationMult;
+    float rotMax = deg2rad(movement.RotationMaxAngle);
+    float totalMove = std::clamp(velComponent + rotComponent,
+        -rotMax,
+        rotMax);
+    float newAngle = -rad2deg(totalMove);
+
+    if (speedVector.y < 3.0f) {
+        newAngle = map(speedVector.y, 0.0f, 3.0f, 0.0f, newAngle);
+        newAngle = std::clamp(newAngle, 0.0f, newAngle);
+    }
+
+    bool isPlane = input.IsPlane;
+    bool isHeli = input.IsHeli;
+    bool isHover = input.HoverTransformRatio > 0.0f;
+    // Only filled in for planes and helis on supported game versions
+    bool isAirHover = (isPlane || isHeli) &&
+        input.FlightNozzlePosition > 0.5f;
+
+    if (isHeli || isHover || isAirHover) {
+        newAngle = 0.0f;
+    }
+
+    mInertiaDirectionLookAngle = lerp(mInertiaDirectionLookAngle, newAngle, mSmoothing.Inertia);
+}
+
+void CCameraSolver::updateInertia(const SCameraSolverInput& input) {
+    const SInertiaLanes lanes = packInertia(input.Camera->Movement);
+
+    // g-force per lane
+    const __m128 accel = _mm_setr_ps(input.AccelerationCentripetal.x, input.Acceleration.y,
+        input.AccelerationCentripetal.z, input.AccelerationCentripetal.y);
+    const __m128 gForce = _mm_div_ps(accel, _mm_setr_ps(9.8f, 9.81f, 9.8f, 9.81f));
+
+    const __m128 negDeadzone = _mm_sub_ps(_mm_setzero_ps(), lanes.Deadzone);
+    const __m128 positive = _mm_cmpgt_ps(gForce, lanes.Deadzone);
+    const __m128 negative = _mm_cmplt_ps(gForce, negDeadzone);
+
+    // map(gForce, deadzone, 10, 0, 10), or from the negative edge below -deadzone.
+    const __m128 mapped = _mm_div_ps(
+        _mm_mul_ps(_mm_sub_ps(gForce, select(positive, lanes.Deadzone, lanes.NegativeEdge)), _mm_set1_ps(10.0f)),
+        _mm_sub_ps(_mm_set1_ps(10.0f), lanes.Deadzone));
+    const __m128 mult = select(positive, lanes.PositiveMult, lanes.NegativeMult);
+    // 0 inside the deadzone
+    const __m128 scaled = _mm_and_ps(_mm_or_ps(positive, negative), _mm_mul_ps(mapped, mult));
+    const __m128 target = _mm_min_ps(_mm_max_ps(scaled, lanes.Min), lanes.Max);
+
+    // lerp, just for smoothness
+    const __m128 value = _mm_load_ps(mInertia);
+    const __m128 lerpF = _mm_set1_ps(mSmoothing.Movement);
+    _mm_store_ps(mInertia, _mm_add_ps(value, _mm_mul_ps(lerpF, _mm_sub_ps(target, value))));
+
+    // The scalar code smoothed the vertical target into the forward offset,
+    // after the longitudinal one, and never moved the height.
+    alignas(16) float targets[4];
+    _mm_store_ps(targets, target);
+    mInertia[Longitudinal] = lerp(mInertia[Longitudinal], targets[Vertical], mSmoothing.Movement);
+    mInertia[Vertical] = 0.0f;
+}
+
+void CCameraSolver::updateDoF(const SCameraSolverInput& input, SCameraSolverOutput& output) {
+    const auto& dof = input.Camera->DoF;
+
+    // smooth out defocusing/focusing
+    auto lerpFactor = mSmoothing.DoF;
+    mAverageAccel = lerp(mAverageAccel, Length(input.AccelerationCentripetal), lerpFactor);
+
+    float averageAcceleration =
+        std::clamp(mAverageAccel, dof.TargetAccelMinDoF, dof.TargetAccelMaxDoF);
+
+    const float vehMaxSpeed = input.EstimatedMaxSpeed / 0.75f;
+    const float speed = input.Speed;
+    const float speedRatio = speed / vehMaxSpeed;
+
+    float nearDoF1 = mapclamp(speedRatio,
+        dof.TargetSpeedMinDoF, dof.TargetSpeedMaxDoF,
+        dof.NearOutFocusMinSpeedDist, dof.NearOutFocusMaxSpeedDist);
+
+    nearDoF1 = mapclamp(averageAcceleration,
+        dof.TargetAccelMinDoF, dof.TargetAccelMaxDoF,
+        nearDoF1 * dof.TargetAccelMinDoFMod, nearDoF1 * dof.TargetAccelMaxDoFMod);
+
+    float nearDoF2 = mapclamp(speedRatio,
+        dof.TargetSpeedMinDoF, dof.TargetSpeedMaxDoF,
+        dof.NearInFocusMinSpeedDist, dof.NearInFocusMaxSpeedDist);
+
+    nearDoF2 = mapclamp(averageAcceleration,
+        dof.TargetAccelMinDoF, dof.TargetAccelMaxDoF,
+        nearDoF2 * dof.TargetAccelMinDoFMod, nearDoF2 * dof.TargetAccelMaxDoFMod);
+
+    float farDoF1 = mapclamp(speedRatio,
+        dof.TargetSpeedMinDoF, dof.TargetSpeedMaxDoF,
+        dof.FarInFocusMinSpeedDist, dof.FarInFocusMaxSpeedDist);
+
+    farDoF1 = mapclamp(averageAcceleration,
+        dof.TargetAccelMinDoF, dof.TargetAccelMaxDoF,
+        farDoF1 / dof.TargetAccelMinDoFMod, farDoF1 / dof.TargetAccelMaxDoFMod);
+
+    float farDoF2 = mapclamp(speedRatio,
+        dof.TargetSpeedMinDoF, dof.TargetSpeedMaxDoF,
+        dof.FarOutFocusMinSpeedDist, dof.FarOutFocusMaxSpeedDist);
+
+    farDoF2 = mapclamp(averageAcceleration,
+        dof.TargetAccelMinDoF, dof.TargetAccelMaxDoF,
+        farDoF2 / dof.TargetAccelMinDoFMod, farDoF2 / dof.TargetAccelMaxDoFMod);
+
+    output.DoFEnabled = true;
+    output.DoFNearOutFocus = nearDoF1;
+    output.DoFNearInFocus = nearDoF2;
+    output.DoFFarInFocus = farDoF1;
+    output.DoFFarOutFocus = farDoF2;
+}
+
+SVector3 CCameraSolver::getLeanOffset(const SCameraSolverInput& input, bool lookingIntoGlass) const {
+    SVector3 leanOffset{};
+
+    const auto& lean = input.Camera->Lean;
+
+    float leanLimitGlass = lookingIntoGlass ? 0.0f : lean.CenterDist;
+
+    // Left
+    if (mRotation.z > 85.0f) {
+        leanOffset.x = map(mRotation.z, 85.0f, 180.0f, 0.0f, -lean.CenterDist);
+        leanOffset.x = std::clamp(leanOffset.x, -lean.CenterDist, leanLimitGlass);
+
+        float frontLean = map(mRotation.z, 85.0f, 180.0f, 0.0f, lean.ForwardDist);
+        frontLean = std::clamp(frontLean, 0.0f, lean.ForwardDist);
+        leanOffset.y += frontLean;
+    }
+    // Right
+    if (mRotation.z < -85.0f) {
+        leanOffset.x = map(mRotation.z, -85.0f, -180.0f, 0.0f, lean.CenterDist);
+        leanOffset.x = std::clamp(leanOffset.x, -leanLimitGlass, lean.CenterDist);
+
+        float frontLean = map(mRotation.z, -85.0f, -180.0f, 0.0f, lean.ForwardDist);
+        frontLean = std::clamp(frontLean, 0.0f, lean.ForwardDist);
+        leanOffset.y += frontLean;
+    }
+    // Don't care
+    if (!lookingIntoGlass && std::abs(mRotation.z) > 85.0f) {
+        float upPeek = map(std::abs(mRotation.z), 85.0f, 160.0f, 0.0f, lean.UpDist);
+        upPeek = std::clamp(upPeek, 0.0f, lean.UpDist);
+        leanOffset.z += upPeek;
+    }
+
+    return leanOffset;
+}
+
+SVector3 CCameraSolver::getHorizonLockRotation(const SCameraSolverInput& input) {
+    const auto& horizonLock = input.Camera->HorizonLock;
+
+    bool horLock = horizonLock.Lock;
+    if (!horLock)
+        return {};
+
+    SVector3 rotations{};
+    const float horPitchLim = horizonLock.PitchLim;
+    const float horRollLim = horizonLock.RollLim;
+
+    const SVector3& vehRot = input.Rotation;
+    float vehPitch = input.Pitch;
+    float vehRoll = input.Roll;
+    float dynamicPitch = 0.0f;
+
+    if (std::abs(vehPitch) > 90.0f) {
+        vehPitch = map(std::abs(vehPitch), 90.0f, 180.0f, 90.0f, 0.0f) * sgn(vehPitch);
+    }
+    else {
+        vehPitch = std::clamp(vehPitch, -horPitchLim, horPitchLim);
+    }
+
+    if (std::abs(vehRoll) > 90.0f) {
+        vehRoll = map(std::abs(vehRoll), 90.0f, 180.0f, 90.0f, 0.0f) * sgn(vehRoll);
+    }
+    else {
+        vehRoll = std::clamp(vehRoll, -horRollLim, horRollLim);
+    }
+
+    switch (horizonLock.PitchMode) {
+        case 2:
+        {
+            float rate = input.FrameTime * horizonLock.CenterSpeed;
+            mDynamicPitch = rate * (vehPitch)+(1.0f - rate) * mDynamicPitch;
+            dynamicPitch = vehPitch - mDynamicPitch;
+            dynamicPitch = std::clamp(dynamicPitch, -horPitchLim, horPitchLim);
+            mDynamicPitch = std::clamp(mDynamicPitch, -horPitchLim, horPitchLim);
+            break;
+        }
+        case 1:
+        {
+            dynamicPitch = 0.0f;
+            break;
+        }
+        case 0: [[fallthrough]];
+        default:
+        {
+            dynamicPitch = vehPitch;
+        }
+    }
+
+    const float lookAngle = std::abs(mRotation.z);
+
+    rotations.x = lookAngle <= 90.0f ?
+        map(lookAngle, 0.0f, 90.0f, dynamicPitch, 0.0f) :
+        map(lookAngle, 90.0f, 180.0f, 0.0f, -dynamicPitch + vehRot.x * 2.0f * lookAngle / 180.0f);
+
+    rotations.y = lookAngle <= 90.0f ?
+        map(lookAngle, 0.0f, 90.0f, vehRoll, 0.0f) :
+        map(lookAngle, 90.0f, 180.0f, 0.0f, vehRoll);
+
+    return rotations;
+}
+
+SVector3 CCameraSolver::getShakeFromSpeed(const SCameraSolverInput& input) {
+    if (!input.OnAllWheels)
+        return {};
+
+    const float amplitudeBase = input.Camera->Movement.ShakeSpeed;
+
+    const float minRateMod = input.ShakeData->MinRateModSpd;
+    const float maxRateMod = input.ShakeData->MaxRateModSpd;
+
+    const float vehMaxSpeed = input.EstimatedMaxSpeed / 0.75f;
+    const float speed = input.Speed;
+
+    // Shake amplitude modifer <-> rpm
+    float rpmModifier = mapclamp(input.RPM, 0.5f, 0.8f, 0.0f, 1.0f);
+
+    // Shake amplitude <-> speed relation:
+    // <  50% speed: no shake
+    // >  90% speed: full shake
+    float amplitude = mapclamp(speed,
+        vehMaxSpeed * 0.4f,
+        vehMaxSpeed * 0.7f,
+        0.0f,
+        amplitudeBase * rpmModifier);
+
+    CShakeNoise::SSample noise = mShakeNoise.Sample(mCumTimeSpeed);
+
+    float shakeRate = mapclamp(speed, 0.0f, vehMaxSpeed, minRateMod, maxRateMod);
+    mCumTimeSpeed = mCumTimeSpeed + input.FrameTime * input.TimeScale * shakeRate;
+
+    return SVector3{
+        noise.Side * amplitude,
+        noise.Vert * amplitude,
+        noise.Roll * 5.0f * amplitude
+    };
+}
+
+SVector3 CCameraSolver::getShakeFromTerrain(const SCameraSolverInput& input) {
+    const float amplitudeBase = input.Camera->Movement.ShakeTerrain;
+
+    const float minRateMod = input.ShakeData->MinRateModTrn;
+    const float maxRateMod = input.ShakeData->MaxRateModTrn;
+
+    const float vehMaxSpeed = input.EstimatedMaxSpeed / 0.75f;
+    const float speed = input.Speed;
+
+    const VehicleExtensions::SWheelData& wheels = input.Wheels;
+
+    float terrainAmplMod = 0.0f;
+    float terrainFreqMod = 1.0f;
+    float terrainMatchCount = 0.0f;
+    for (int i = 0; i < wheels.Count; ++i) {
+        const SShakeParams* reaction = input.ShakeData->FindMaterialReaction(wheels.Material[i]);
+
+        if (wheels.OnGround[i] && reaction) {
+            terrainAmplMod += reaction->Amplitude / static_cast<float>(wheels.Count);
+
+            terrainFreqMod += reaction->Frequency;
+            terrainMatchCount += 1.0f;
+        }
+    }
+
+    if (terrainMatchCount > 0.0f) {
+        terrainFreqMod /= terrainMatchCount;
+    }
+
+    float amplitude = mapclamp(speed,
+        0.0f,
+        vehMaxSpeed * 0.3f,
+        0.0f,
+        amplitudeBase * terrainAmplMod);
+
+    CShakeNoise::SSample noise = mShakeNoise.Sample(mCumTimeTerrain);
+
+    float shakeRate = mapclamp(speed, 0.0f, vehMaxSpeed, minRateMod, maxRateMod) * terrainFreqMod;
+    mCumTimeTerrain = mCumTimeTerrain + input.FrameTime * input.TimeScale * shakeRate;
+
+    return SVector3{
+        noise.Side * amplitude,
+        noise.Vert * amplitude,
+        noise.Roll * 5.0f * amplitude
+    };
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include "SolverTypes.hpp"
+#include "../Config.hpp"
+#include "../ShakeData.hpp"
+#include "../Memory/WheelData.hpp"
+#include "../Util/Profiler.hpp"
+#include "../Util/ShakeNoise.hpp"
+
+#include <limits>
+
+// Everything the camera needs for one frame. Filled by the script from
+// natives, or by anything else that can provide the same values.
+struct SCameraSolverInput {
+    // Seconds
+    float FrameTime = 0.0f;
+    float TimeScale = 1.0f;
+
+    const CConfig::SCameraSettings* Camera = nullptr;
+    const CConfig::SLook* Look = nullptr;
+    // Optional, no shake without it
+    const CShakeData* ShakeData = nullptr;
+
+    // Vehicle state, see SVehicleSnapshot
+    // Degrees, rotation order 0
+    SVector3 Rotation{};
+    SVector3 RotationVelocity{};
+    // Relative to the vehicle
+    SVector3 SpeedVector{};
+
+    // Degrees
+    float Pitch = 0.0f;
+    float Roll = 0.0f;
+
+    float Speed = 0.0f;
+    float EstimatedMaxSpeed = 0.0f;
+    float RPM = 0.0f;
+    float HoverTransformRatio = 0.0f;
+    float FlightNozzlePosition = 0.0f;
+    bool OnAllWheels = false;
+    VehicleExtensions::SWheelData Wheels;
+
+    // Relative to the vehicle, m/s^2
+    SVector3 Acceleration{};
+    SVector3 AccelerationCentripetal{};
+
+    bool IsPlane = false;
+    bool IsHeli = false;
+    ESeatPosition SeatPosition = ESeatPosition::Center;
+    bool DriverWindowPresent = false;
+
+    // Controls
+    ELookInput LookInput = ELookInput::Controller;
+    // Control normals, -1.0 to 1.0
+    float LookLeftRight = 0.0f;
+    float LookUpDown = 0.0f;
+    bool LookBehind = false;
+
+    // Manual Transmission look buttons
+    bool MTLookLeft = false;
+    bool MTLookRight = false;
+    bool MTLookBack = false;
+};
+
+struct SCameraSolverOutput {
+    // Side, forward, up from the mount point, in meters.
+    // Seat offsets for vehicle mounts are up to the caller.
+    SVector3 Offset{};
+    // Absolute, degrees, rotation order 0
+    SVector3 Rotation{};
+    float FOV = 0.0f;
+    // Degrees, 0 to 360
+    float MinimapAngle = 0.0f;
+
+    bool DoFEnabled = false;
+    float DoFNearOutFocus = 0.0f;
+    float DoFNearInFocus = 0.0f;
+    float DoFFarInFocus = 0.0f;
+    float DoFFarOutFocus = 0.0f;
+};
+
+// The first person camera math: look, lean, inertia, horizon lock, shake and DoF.
+// Keeps the smoothing state between frames, but doesn't touch the game at all.
+class CCameraSolver {
+public:
+    CCameraSolver();
+
+    // Drops all smoothed state, e.g. when the camera is cancelled.
+    void Reset();
+    // Restarts the shake noise, e.g. when the camera is created.
+    void ResetShake();
+
+    SCameraSolverOutput Solve(const SCameraSolverInput& input);
+
+    // Optional, times the inertia, shake and DoF stages.
+    void SetProfiler(CProfiler* profiler) { mProfiler = profiler; }
+
+    // Look rotation relative to the vehicle, degrees
+    const SVector3& LookRotation() const { return mRotation; }
+
+private:
+    // Lerp factors 1 - k^dt for the smoothing constants k. They only depend on
+    // the frame time and three settings, so they're computed once per frame,
+    // and reused as long as neither changes.
+    struct SSmoothing {
+        // What the factors are for. NaN, so the first frame always computes them.
+        float FrameTime = std::numeric_limits<float>::quiet_NaN();
+        float LookTime = std::numeric_limits<float>::quiet_NaN();
+        float MouseLookTime = std::numeric_limits<float>::quiet_NaN();
+        float Roughness = std::numeric_limits<float>::quiet_NaN();
+
+        // log2(k), only recomputed when the settings change
+        float Log2LookTime = 0.0f;
+        float Log2MouseLookTime = 0.0f;
+        float Log2Roughness = 0.0f;
+
+        float Look = 0.0f;
+        float MouseLook = 0.0f;
+        float Inertia = 0.0f;
+        float Movement = 0.0f;
+        float DoF = 0.0f;
+    };
+
+    // Lanes of mInertia
+    enum EInertiaLane {
+        Lateral,
+        Longitudinal,
+        Vertical,
+        Pitch,
+    };
+
+    void updateSmoothing(const SCameraSolverInput& input);
+
+    float getRearLookAngle(ESeatPosition seatPosition, float lookLeftRight, float maxAngle) const;
+    void updateControllerLook(const SCameraSolverInput& input, bool& lookingIntoGlass);
+    void updateMouseLook(const SCameraSolverInput& input, bool& lookingIntoGlass);
+    void updateWheelLook(const SCameraSolverInput& input, bool& lookingIntoGlass);
+
+    void updateRotationCameraMovement(const SCameraSolverInput& input);
+
+    // The lateral, longitudinal, vertical and pitch inertia as one SSE filter.
+    // Every lane maps its g-force past the deadzone to 0-10, scales it by the
+    // multiplier for its direction, clamps it to the limits and smooths it.
+    // Like the scalar code, the vertical result ends up in the forward offset.
+    void updateInertia(const SCameraSolverInput& input);
+
+    void updateDoF(const SCameraSolverInput& input, SCameraSolverOutput& output);
+
+    SVector3 getLeanOffset(const SCameraSolverInput& input, bool lookingIntoGlass) const;
+    SVector3 getHorizonLockRotation(const SCameraSolverInput& input);
+
+    // X, Z, Roll
+    SVector3 getShakeFromSpeed(const SCameraSolverInput& input);
+    SVector3 getShakeFromTerrain(const SCameraSolverInput& input);
+
+    SVector3 mRotation{};
+
+    // Accumulated values for mouse look
+    SVector3 mLookAcc{};
+    // Seconds since the last mouse input, for re-centering
+    float mLookIdleTime = 0.0f;
+
+    // rotation camera movement
+    float mInertiaDirectionLookAngle = 0.0f;
+
+    // side, forward, vertical (meters) and pitch (degrees) camera movement, see EInertiaLane.
+    // Vertical is kept at 0, see updateInertia().
+    alignas(16) float mInertia[4]{};
+
+    // in degrees
+    float mDynamicPitch = 0.0f;
+
+    float mAverageAccel = 0.0f;
+
+    // For Manual Transmission
+    // Figure out which side to look "back" with:
+    // When the LookRight is pressed first, and then LookLeft is pressed
+    // camera should look back over the right shoulder - otherwise left shoulder.
+    bool mMTLookRightPrev = false;
+    bool mMTLookLeftPrev = false;
+    bool mMTLookBackRightShoulder = false;
+
+    CProfiler* mProfiler = nullptr;
+
+    SSmoothing mSmoothing;
+
+    CShakeNoise mShakeNoise;
+    double mCumTimeSpeed = 0.0;
+    double mCumTimeTerrain = 0.0;
+};
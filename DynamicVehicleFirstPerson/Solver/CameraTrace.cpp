@@ -0,0 +1,470 @@
+#include "CameraTrace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace {
+    // Bump when the record layout changes.
+    constexpr uint32_t traceVersion = 1;
+    constexpr char traceMagic[4] = { 'F', 'P', 'V', 'T' };
+
+    // Flush to disk once this much is buffered.
+    constexpr size_t flushSize = 64 * 1024;
+
+    // The plain structs are copied as-is, so their sizes are part of the header.
+    // Same idea as the config cache.
+    struct SHeader {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t LeanSize;
+        uint32_t MovementSize;
+        uint32_t HorizonLockSize;
+        uint32_t DoFSize;
+        uint32_t LookSize;
+        uint32_t FrameSize;
+    };
+
+    enum EFrameFlags : uint8_t {
+        OnAllWheels         = 1 << 0,
+        IsPlane             = 1 << 1,
+        IsHeli              = 1 << 2,
+        DriverWindowPresent = 1 << 3,
+        LookBehind          = 1 << 4,
+        MTLookLeft          = 1 << 5,
+        MTLookRight         = 1 << 6,
+        MTLookBack          = 1 << 7,
+    };
+
+    // Fixed part of a frame record, followed by WheelCount compressions,
+    // WheelCount materials and the on-ground bits.
+    struct STraceFrame {
+        float FrameTime;
+        float TimeScale;
+        SVector3 Rotation;
+        SVector3 RotationVelocity;
+        SVector3 SpeedVector;
+        float Pitch;
+        float Roll;
+        float Speed;
+        float EstimatedMaxSpeed;
+        float RPM;
+        float HoverTransformRatio;
+        float FlightNozzlePosition;
+        SVector3 Acceleration;
+        SVector3 AccelerationCentripetal;
+        float LookLeftRight;
+        float LookUpDown;
+        uint8_t Flags;
+        uint8_t LookInput;
+        uint8_t SeatPosition;
+        uint8_t WheelCount;
+    };
+
+    static_assert(std::is_trivially_copyable_v<STraceFrame>);
+    static_assert(sizeof(STraceFrame) == 108, "STraceFrame should not have padding");
+    static_assert(VehicleExtensions::SWheelData::MaxWheels <= 16, "On-ground bits are stored in 16 bits");
+
+    SHeader makeHeader() {
+        SHeader header{
+            .Magic = {},
+            .Version = traceVersion,
+            .LeanSize = sizeof(CConfig::SLean),
+            .MovementSize = sizeof(CConfig::SMovement),
+            .HorizonLockSize = sizeof(CConfig::SHorizonLock),
+            .DoFSize = sizeof(CConfig::SDoF),
+            .LookSize = sizeof(CConfig::SLook),
+            .FrameSize = sizeof(STraceFrame),
+        };
+        std::memcpy(header.Magic, traceMagic, sizeof(traceMagic));
+        return header;
+    }
+
+    template <typename T>
+    void appendRaw(std::string& data, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Every read is bounds checked, a truncated trace just ends with an error.
+    class CReader {
+    public:
+        CReader(const std::string& data, size_t cursor, size_t end)
+            : mData(data), mCursor(cursor), mEnd(end) {}
+
+        template <typename T>
+        bool Raw(T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (mEnd - mCursor < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, mData.data() + mCursor, sizeof(T));
+            mCursor += sizeof(T);
+            return true;
+        }
+
+        size_t Cursor() const { return mCursor; }
+
+    private:
+        const std::string& mData;
+        size_t mCursor;
+        size_t mEnd;
+    };
+
+    void appendSettings(std::string& data, const SCameraSolverInput& input) {
+        const auto& camera = *input.Camera;
+        appendRaw(data, static_cast<int32_t>(camera.MountPoint));
+        appendRaw(data, camera.FOV);
+        appendRaw(data, camera.OffsetHeight);
+        appendRaw(data, camera.OffsetForward);
+        appendRaw(data, camera.OffsetSide);
+        appendRaw(data, camera.Pitch);
+        appendRaw(data, camera.Lean);
+        appendRaw(data, camera.HorizonLock);
+        appendRaw(data, camera.Movement);
+        appendRaw(data, camera.DoF);
+        appendRaw(data, *input.Look);
+
+        appendRaw(data, static_cast<uint8_t>(input.ShakeData != nullptr));
+        if (input.ShakeData) {
+            const auto& shake = *input.ShakeData;
+            appendRaw(data, shake.MinRateModSpd);
+            appendRaw(data, shake.MaxRateModSpd);
+            appendRaw(data, shake.MinRateModTrn);
+            appendRaw(data, shake.MaxRateModTrn);
+            appendRaw(data, static_cast<uint32_t>(shake.MaterialReactions().size()));
+            for (const auto& reaction : shake.MaterialReactions()) {
+                appendRaw(data, static_cast<uint16_t>(reaction.Material));
+                appendRaw(data, reaction.Params);
+            }
+        }
+    }
+}
+
+CCameraTraceWriter::~CCameraTraceWriter() {
+    Close();
+}
+
+bool CCameraTraceWriter::Open(const std::filesystem::path& traceFile) {
+    Close();
+
+    std::error_code ec;
+    if (traceFile.has_parent_path()) {
+        std::filesystem::create_directories(traceFile.parent_path(), ec);
+    }
+
+    mFile.open(traceFile, std::ios::binary | std::ios::trunc);
+    if (!mFile.is_open()) {
+        return false;
+    }
+
+    mBuffer.clear();
+    mBuffer.reserve(flushSize);
+    mSettings.clear();
+    mLastRecord = ETraceRecord::End;
+    mFrames = 0;
+
+    appendRaw(mBuffer, makeHeader());
+    return flush(true);
+}
+
+void CCameraTraceWriter::Close() {
+    if (!mFile.is_open()) {
+        return;
+    }
+    flush(true);
+    mFile.close();
+}
+
+bool CCameraTraceWriter::WriteFrame(const SCameraSolverInput& input) {
+    if (!mFile.is_open() || !input.Camera || !input.Look) {
+        return false;
+    }
+
+    // Settings only change through the menu, so this is rarely written.
+    // Serializing them every frame is cheaper than tracking every edit.
+    mSettingsScratch.clear();
+    appendSettings(mSettingsScratch, input);
+    if (mSettingsScratch != mSettings) {
+        appendRaw(mBuffer, ETraceRecord::Settings);
+        appendRaw(mBuffer, static_cast<uint32_t>(mSettingsScratch.size()));
+        mBuffer.append(mSettingsScratch);
+        mSettings.swap(mSettingsScratch);
+    }
+
+    const auto& wheels = input.Wheels;
+    uint8_t wheelCount = std::min(wheels.Count, VehicleExtensions::SWheelData::MaxWheels);
+
+    uint8_t flags = 0;
+    if (input.OnAllWheels)          flags |= OnAllWheels;
+    if (input.IsPlane)              flags |= IsPlane;
+    if (input.IsHeli)               flags |= IsHeli;
+    if (input.DriverWindowPresent)  flags |= DriverWindowPresent;
+    if (input.LookBehind)           flags |= LookBehind;
+    if (input.MTLookLeft)           flags |= MTLookLeft;
+    if (input.MTLookRight)          flags |= MTLookRight;
+    if (input.MTLookBack)           flags |= MTLookBack;
+
+    STraceFrame frame{
+        .FrameTime = input.FrameTime,
+        .TimeScale = input.TimeScale,
+        .Rotation = input.Rotation,
+        .RotationVelocity = input.RotationVelocity,
+        .SpeedVector = input.SpeedVector,
+        .Pitch = input.Pitch,
+        .Roll = input.Roll,
+        .Speed = input.Speed,
+        .EstimatedMaxSpeed = input.EstimatedMaxSpeed,
+        .RPM = input.RPM,
+        .HoverTransformRatio = input.HoverTransformRatio,
+        .FlightNozzlePosition = input.FlightNozzlePosition,
+        .Acceleration = input.Acceleration,
+        .AccelerationCentripetal = input.AccelerationCentripetal,
+        .LookLeftRight = input.LookLeftRight,
+        .LookUpDown = input.LookUpDown,
+        .Flags = flags,
+        .LookInput = static_cast<uint8_t>(input.LookInput),
+        .SeatPosition = static_cast<uint8_t>(input.SeatPosition),
+        .WheelCount = wheelCount,
+    };
+
+    appendRaw(mBuffer, ETraceRecord::Frame);
+    appendRaw(mBuffer, frame);
+    mBuffer.append(reinterpret_cast<const char*>(wheels.Compression), wheelCount * sizeof(float));
+    mBuffer.append(reinterpret_cast<const char*>(wheels.Material), wheelCount * sizeof(uint16_t));
+    uint16_t onGround = 0;
+    for (uint8_t i = 0; i < wheelCount; ++i) {
+        if (wheels.OnGround[i]) {
+            onGround |= static_cast<uint16_t>(1 << i);
+        }
+    }
+    appendRaw(mBuffer, onGround);
+
+    mLastRecord = ETraceRecord::Frame;
+    ++mFrames;
+    return flush(false);
+}
+
+bool CCameraTraceWriter::WriteReset() {
+    return writeEvent(ETraceRecord::Reset);
+}
+
+bool CCameraTraceWriter::WriteResetShake() {
+    return writeEvent(ETraceRecord::ResetShake);
+}
+
+bool CCameraTraceWriter::writeEvent(ETraceRecord record) {
+    if (!mFile.is_open()) {
+        return false;
+    }
+    // Reset is called every tick while the camera is inactive, one is enough.
+    if (record == mLastRecord) {
+        return true;
+    }
+    appendRaw(mBuffer, record);
+    mLastRecord = record;
+    return flush(false);
+}
+
+bool CCameraTraceWriter::flush(bool force) {
+    if (mBuffer.empty() || (!force && mBuffer.size() < flushSize)) {
+        return true;
+    }
+    mFile.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+    mBuffer.clear();
+    if (!mFile) {
+        mFile.close();
+        return false;
+    }
+    return true;
+}
+
+bool CCameraTraceReader::Open(const std::filesystem::path& traceFile) {
+    mData.clear();
+    mError.clear();
+    mHasSettings = false;
+
+    std::ifstream file(traceFile, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        mError = "Failed to open " + traceFile.string();
+        return false;
+    }
+
+    mData.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(mData.data(), static_cast<std::streamsize>(mData.size()))) {
+        mError = "Failed to read " + traceFile.string();
+        return false;
+    }
+
+    SHeader header{};
+    CReader reader(mData, 0, mData.size());
+    if (!reader.Raw(header) || std::memcmp(header.Magic, traceMagic, sizeof(traceMagic)) != 0) {
+        mError = "Not a camera trace";
+        return false;
+    }
+
+    const SHeader expected = makeHeader();
+    if (std::memcmp(&header, &expected, sizeof(SHeader)) != 0) {
+        mError = "Trace version " + std::to_string(header.Version) +
+            " doesn't match this build (version " + std::to_string(expected.Version) + "), or its layout differs";
+        return false;
+    }
+
+    mFirstRecord = reader.Cursor();
+    mCursor = mFirstRecord;
+    return true;
+}
+
+void CCameraTraceReader::Rewind() {
+    mCursor = mFirstRecord;
+    mHasSettings = false;
+}
+
+ETraceRecord CCameraTraceReader::Next(SCameraSolverInput& input) {
+    while (mCursor < mData.size()) {
+        auto record = static_cast<ETraceRecord>(mData[mCursor]);
+        ++mCursor;
+
+        switch (record) {
+            case ETraceRecord::Settings: {
+                uint32_t size = 0;
+                CReader reader(mData, mCursor, mData.size());
+                if (!reader.Raw(size) || mData.size() - reader.Cursor() < size) {
+                    mError = "Truncated settings record";
+                    return ETraceRecord::Error;
+                }
+                mCursor = reader.Cursor();
+                if (!readSettings(size)) {
+                    mError = "Corrupt settings record";
+                    return ETraceRecord::Error;
+                }
+                continue;
+            }
+            case ETraceRecord::Frame:
+                if (!mHasSettings) {
+                    mError = "Frame before settings";
+                    return ETraceRecord::Error;
+                }
+                if (!readFrame(input)) {
+                    mError = "Truncated frame record";
+                    return ETraceRecord::Error;
+                }
+                return record;
+            case ETraceRecord::Reset:
+            case ETraceRecord::ResetShake:
+                return record;
+            default:
+                mError = "Unknown record type " + std::to_string(static_cast<int>(record)) +
+                    " at offset " + std::to_string(mCursor - 1);
+                return ETraceRecord::Error;
+        }
+    }
+    return ETraceRecord::End;
+}
+
+bool CCameraTraceReader::readSettings(size_t size) {
+    const size_t end = mCursor + size;
+    CReader reader(mData, mCursor, end);
+
+    int32_t mountPoint = 0;
+    bool ok = reader.Raw(mountPoint) &&
+        reader.Raw(mCamera.FOV) &&
+        reader.Raw(mCamera.OffsetHeight) &&
+        reader.Raw(mCamera.OffsetForward) &&
+        reader.Raw(mCamera.OffsetSide) &&
+        reader.Raw(mCamera.Pitch) &&
+        reader.Raw(mCamera.Lean) &&
+        reader.Raw(mCamera.HorizonLock) &&
+        reader.Raw(mCamera.Movement) &&
+        reader.Raw(mCamera.DoF) &&
+        reader.Raw(mLook);
+    mCamera.MountPoint = static_cast<CConfig::EMountPoint>(mountPoint);
+
+    uint8_t hasShake = 0;
+    ok = ok && reader.Raw(hasShake);
+    if (ok && hasShake) {
+        uint32_t count = 0;
+        ok = reader.Raw(mShakeData.MinRateModSpd) &&
+            reader.Raw(mShakeData.MaxRateModSpd) &&
+            reader.Raw(mShakeData.MinRateModTrn) &&
+            reader.Raw(mShakeData.MaxRateModTrn) &&
+            reader.Raw(count);
+
+        std::vector<SMaterialReaction> reactions;
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            uint16_t material = 0;
+            SShakeParams params{};
+            ok = reader.Raw(material) && reader.Raw(params);
+            reactions.push_back({ static_cast<eMaterial>(material), params });
+        }
+        mShakeData.SetMaterialReactions(std::move(reactions));
+    }
+
+    mHasShake = hasShake != 0;
+    mHasSettings = ok && reader.Cursor() == end;
+    mCursor = end;
+    return mHasSettings;
+}
+
+bool CCameraTraceReader::readFrame(SCameraSolverInput& input) {
+    CReader reader(mData, mCursor, mData.size());
+
+    STraceFrame frame{};
+    if (!reader.Raw(frame) || frame.WheelCount > VehicleExtensions::SWheelData::MaxWheels) {
+        return false;
+    }
+
+    const size_t wheelsSize = frame.WheelCount * (sizeof(float) + sizeof(uint16_t)) + sizeof(uint16_t);
+    if (mData.size() - reader.Cursor() < wheelsSize) {
+        return false;
+    }
+    mCursor = reader.Cursor();
+
+    input.FrameTime = frame.FrameTime;
+    input.TimeScale = frame.TimeScale;
+    input.Camera = &mCamera;
+    input.Look = &mLook;
+    input.ShakeData = mHasShake ? &mShakeData : nullptr;
+    input.Rotation = frame.Rotation;
+    input.RotationVelocity = frame.RotationVelocity;
+    input.SpeedVector = frame.SpeedVector;
+    input.Pitch = frame.Pitch;
+    input.Roll = frame.Roll;
+    input.Speed = frame.Speed;
+    input.EstimatedMaxSpeed = frame.EstimatedMaxSpeed;
+    input.RPM = frame.RPM;
+    input.HoverTransformRatio = frame.HoverTransformRatio;
+    input.FlightNozzlePosition = frame.FlightNozzlePosition;
+    input.Acceleration = frame.Acceleration;
+    input.AccelerationCentripetal = frame.AccelerationCentripetal;
+    input.LookLeftRight = frame.LookLeftRight;
+    input.LookUpDown = frame.LookUpDown;
+    input.LookInput = static_cast<ELookInput>(frame.LookInput);
+    input.SeatPosition = static_cast<ESeatPosition>(frame.SeatPosition);
+
+    input.OnAllWheels         = frame.Flags & OnAllWheels;
+    input.IsPlane             = frame.Flags & IsPlane;
+    input.IsHeli              = frame.Flags & IsHeli;
+    input.DriverWindowPresent = frame.Flags & DriverWindowPresent;
+    input.LookBehind          = frame.Flags & LookBehind;
+    input.MTLookLeft          = frame.Flags & MTLookLeft;
+    input.MTLookRight         = frame.Flags & MTLookRight;
+    input.MTLookBack          = frame.Flags & MTLookBack;
+
+    auto& wheels = input.Wheels;
+    wheels = {};
+    wheels.Count = frame.WheelCount;
+    std::memcpy(wheels.Compression, mData.data() + mCursor, frame.WheelCount * sizeof(float));
+    mCursor += frame.WheelCount * sizeof(float);
+    std::memcpy(wheels.Material, mData.data() + mCursor, frame.WheelCount * sizeof(uint16_t));
+    mCursor += frame.WheelCount * sizeof(uint16_t);
+    uint16_t onGround = 0;
+    std::memcpy(&onGround, mData.data() + mCursor, sizeof(uint16_t));
+    mCursor += sizeof(uint16_t);
+    for (uint8_t i = 0; i < frame.WheelCount; ++i) {
+        wheels.OnGround[i] = (onGround >> i) & 1;
+    }
+    return true;
+}
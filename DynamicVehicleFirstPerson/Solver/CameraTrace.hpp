@@ -0,0 +1,89 @@
+#pragma once
+#include "CameraSolver.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Binary recording of camera solver inputs, so a drive can be replayed
+// and profiled without the game.
+// A trace is a header followed by records:
+// - Settings: camera, look and shake settings. Written before the first frame,
+//   and again whenever they change.
+// - Frame: the rest of SCameraSolverInput.
+// - Reset, ResetShake: the matching CCameraSolver call happened.
+enum class ETraceRecord : uint8_t {
+    Settings,
+    Frame,
+    Reset,
+    ResetShake,
+    // Not in the file, returned by the reader
+    End,
+    Error,
+};
+
+class CCameraTraceWriter {
+public:
+    CCameraTraceWriter() = default;
+    ~CCameraTraceWriter();
+
+    bool Open(const std::filesystem::path& traceFile);
+    void Close();
+    bool IsOpen() const { return mFile.is_open(); }
+
+    // Returns false once writing failed, the trace is closed then.
+    bool WriteFrame(const SCameraSolverInput& input);
+    bool WriteReset();
+    bool WriteResetShake();
+
+    uint64_t FrameCount() const { return mFrames; }
+
+private:
+    bool writeEvent(ETraceRecord record);
+    bool flush(bool force);
+
+    std::ofstream mFile;
+    // Records are collected here and written in chunks.
+    std::string mBuffer;
+    // Last written settings record, to only write changes.
+    std::string mSettings;
+    std::string mSettingsScratch;
+    ETraceRecord mLastRecord = ETraceRecord::End;
+    uint64_t mFrames = 0;
+};
+
+class CCameraTraceReader {
+public:
+    CCameraTraceReader() = default;
+    CCameraTraceReader(const CCameraTraceReader&) = delete;
+    CCameraTraceReader& operator=(const CCameraTraceReader&) = delete;
+
+    // Reads the whole trace into memory.
+    bool Open(const std::filesystem::path& traceFile);
+
+    // Settings records are applied internally and skipped, so this only returns
+    // Frame, Reset, ResetShake, End or Error.
+    // For Frame, input is filled. Its settings pointers point into the reader.
+    ETraceRecord Next(SCameraSolverInput& input);
+
+    // Back to the first record, to replay the trace again.
+    void Rewind();
+
+    const std::string& Error() const { return mError; }
+
+private:
+    bool readSettings(size_t size);
+    bool readFrame(SCameraSolverInput& input);
+
+    std::string mData;
+    size_t mFirstRecord = 0;
+    size_t mCursor = 0;
+    std::string mError;
+
+    bool mHasSettings = false;
+    bool mHasShake = false;
+    CConfig::SCameraSettings mCamera;
+    CConfig::SLook mLook;
+    CShakeData mShakeData;
+};
@@ -0,0 +1,424 @@
+#include "DriveScenario.hpp"
+
+#include "../Util/Math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr float gravity = 9.81f;
+    constexpr float twoPi = 2.0f * static_cast<float>(M_PI);
+
+    // m/s
+    constexpr float carMaxSpeed = 55.0f;
+    constexpr float bikeMaxSpeed = 50.0f;
+    constexpr float heliMaxSpeed = 45.0f;
+
+    // Front to rear axle, meters
+    constexpr float carWheelbase = 2.6f;
+
+    // Suspension compression at rest
+    constexpr float restCompression = 0.12f;
+
+    constexpr uint16_t material(eMaterial value) {
+        return static_cast<uint16_t>(value);
+    }
+
+    struct SNamedScenario {
+        const char* Name;
+        float Duration;
+    };
+
+    constexpr std::array<SNamedScenario, static_cast<size_t>(EDriveScenario::Count)> scenarios{ {
+        { "hard-launch", 8.0f },
+        { "emergency-brake", 7.0f },
+        { "slalom", 12.0f },
+        { "rumble-strip", 6.0f },
+        { "pothole-field", 8.0f },
+        { "jump", 6.0f },
+        { "heli-hover", 10.0f },
+        { "bike-lean", 12.0f },
+    } };
+
+    // Yaw, then pitch, then roll, like the game's rotation order 2.
+    SVector3 rotate(const SVector3& v, float pitchDeg, float rollDeg, float yawDeg) {
+        const float p = deg2rad(pitchDeg);
+        const float r = deg2rad(rollDeg);
+        const float y = deg2rad(yawDeg);
+
+        // Roll around Y
+        SVector3 out{
+            v.x * std::cos(r) + v.z * std::sin(r),
+            v.y,
+            -v.x * std::sin(r) + v.z * std::cos(r),
+        };
+        // Pitch around X
+        out = {
+            out.x,
+            out.y * std::cos(p) - out.z * std::sin(p),
+            out.y * std::sin(p) + out.z * std::cos(p),
+        };
+        // Yaw around Z
+        return {
+            out.x * std::cos(y) - out.y * std::sin(y),
+            out.x * std::sin(y) + out.y * std::cos(y),
+            out.z,
+        };
+    }
+
+    // Deterministic 0.0 to 1.0 per integer, for placing potholes.
+    float hash01(int32_t value, uint32_t salt) {
+        uint32_t x = static_cast<uint32_t>(value) * 0x9E3779B1u ^ salt;
+        x ^= x >> 16;
+        x *= 0x85EBCA6Bu;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35u;
+        x ^= x >> 16;
+        return static_cast<float>(x & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+    }
+
+    // Damped spring response to a step at t = 0, for body pitch after braking or landing.
+    float settle(float t, float amplitude, float period, float decay) {
+        if (t < 0.0f) {
+            return 0.0f;
+        }
+        return amplitude * std::exp(-t / decay) * std::cos(twoPi * t / period);
+    }
+}
+
+CDriveScenario::CDriveScenario(EDriveScenario scenario, float frameRate, float duration)
+    : mScenario(scenario)
+    , mFrameTime(1.0f / std::max(frameRate, 1.0f)) {
+    if (duration <= 0.0f) {
+        duration = DefaultDuration(scenario);
+    }
+    mFrameCount = static_cast<uint32_t>(std::ceil(duration / mFrameTime));
+}
+
+const char* CDriveScenario::Name(EDriveScenario scenario) {
+    const auto index = static_cast<size_t>(scenario);
+    return index < scenarios.size() ? scenarios[index].Name : "unknown";
+}
+
+bool CDriveScenario::FromName(std::string_view name, EDriveScenario& scenario) {
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        if (name == scenarios[i].Name) {
+            scenario = static_cast<EDriveScenario>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+float CDriveScenario::DefaultDuration(EDriveScenario scenario) {
+    const auto index = static_cast<size_t>(scenario);
+    return index < scenarios.size() ? scenarios[index].Duration : 0.0f;
+}
+
+void CDriveScenario::Rewind() {
+    *this = CDriveScenario(mScenario, 1.0f / mFrameTime, static_cast<float>(mFrameCount) * mFrameTime);
+}
+
+bool CDriveScenario::Next(SCameraSolverInput& input) {
+    if (mFrame >= mFrameCount) {
+        return false;
+    }
+
+    const float dt = mFrameTime;
+    const float t = static_cast<float>(mFrame) * dt;
+    const SMotion motion = motionAt(t);
+
+    mYaw += rad2deg(motion.YawRate * dt);
+    mYaw = std::fmod(mYaw + 540.0f, 360.0f) - 180.0f;
+
+    const SVector3 heading = rotate({ motion.SideSpeed, motion.ForwardSpeed, 0.0f }, 0.0f, 0.0f, mYaw);
+    const SVector3 worldVelocity{ heading.x, heading.y, motion.VerticalSpeed };
+
+    const SVector3 right = rotate({ 1.0f, 0.0f, 0.0f }, motion.Pitch, motion.Roll, mYaw);
+    const SVector3 forward = rotate({ 0.0f, 1.0f, 0.0f }, motion.Pitch, motion.Roll, mYaw);
+    const SVector3 up = rotate({ 0.0f, 0.0f, 1.0f }, motion.Pitch, motion.Roll, mYaw);
+
+    const SVector3 speedVector{
+        Dot(worldVelocity, right),
+        Dot(worldVelocity, forward),
+        Dot(worldVelocity, up),
+    };
+
+    if (mFrame == 0) {
+        mPrevWorldVelocity = worldVelocity;
+        mPrevSpeedVector = speedVector;
+        mPrevPitch = motion.Pitch;
+        mPrevRoll = motion.Roll;
+    }
+
+    setupVehicle(input);
+    input.FrameTime = dt;
+    input.TimeScale = 1.0f;
+
+    input.Rotation = { motion.Pitch, motion.Roll, mYaw };
+    input.RotationVelocity = {
+        deg2rad(motion.Pitch - mPrevPitch) / dt,
+        deg2rad(motion.Roll - mPrevRoll) / dt,
+        motion.YawRate,
+    };
+    input.SpeedVector = speedVector;
+    input.Pitch = motion.Pitch;
+    input.Roll = motion.Roll;
+    input.Speed = Length(worldVelocity);
+    input.RPM = motion.RPM >= 0.0f ?
+        motion.RPM :
+        std::clamp(0.2f + 0.8f * std::abs(motion.ForwardSpeed) / input.EstimatedMaxSpeed, 0.2f, 1.0f);
+    input.Wheels = motion.Wheels;
+
+    input.OnAllWheels = motion.Wheels.Count > 0;
+    for (uint8_t i = 0; i < motion.Wheels.Count; ++i) {
+        input.OnAllWheels = input.OnAllWheels && motion.Wheels.OnGround[i];
+    }
+
+    // Same as CVehicleMetaData
+    input.Acceleration = (speedVector - mPrevSpeedVector) / dt;
+    const SVector3 worldVelocityDelta = worldVelocity - mPrevWorldVelocity;
+    input.AccelerationCentripetal = SVector3{
+        -Dot(worldVelocityDelta, right),
+        Dot(worldVelocityDelta, forward),
+        Dot(worldVelocityDelta, up),
+    } / dt;
+
+    mPrevWorldVelocity = worldVelocity;
+    mPrevSpeedVector = speedVector;
+    mPrevPitch = motion.Pitch;
+    mPrevRoll = motion.Roll;
+    mDistance += motion.ForwardSpeed * dt;
+    ++mFrame;
+    return true;
+}
+
+void CDriveScenario::setupVehicle(SCameraSolverInput& input) const {
+    input.IsPlane = false;
+    input.IsHeli = mScenario == EDriveScenario::HeliHover;
+    input.HoverTransformRatio = 0.0f;
+    input.FlightNozzlePosition = 0.0f;
+
+    switch (mScenario) {
+        case EDriveScenario::HeliHover:
+            input.EstimatedMaxSpeed = heliMaxSpeed;
+            input.SeatPosition = ESeatPosition::Left;
+            input.DriverWindowPresent = true;
+            break;
+        case EDriveScenario::BikeLean:
+            input.EstimatedMaxSpeed = bikeMaxSpeed;
+            input.SeatPosition = ESeatPosition::Center;
+            input.DriverWindowPresent = false;
+            break;
+        default:
+            input.EstimatedMaxSpeed = carMaxSpeed;
+            input.SeatPosition = ESeatPosition::Left;
+            input.DriverWindowPresent = true;
+            break;
+    }
+}
+
+void CDriveScenario::fillWheels(SMotion& motion, float compression, uint16_t wheelMaterial) const {
+    auto& wheels = motion.Wheels;
+    wheels.Count = mScenario == EDriveScenario::BikeLean ? 2 : 4;
+    for (uint8_t i = 0; i < wheels.Count; ++i) {
+        // A little road texture, out of phase per wheel
+        wheels.Compression[i] = compression > 0.0f ?
+            compression + 0.004f * std::sin(1.7f * mDistance + static_cast<float>(i)) :
+            0.0f;
+        wheels.Material[i] = wheelMaterial;
+        wheels.OnGround[i] = wheels.Compression[i] > 0.0f;
+    }
+}
+
+CDriveScenario::SMotion CDriveScenario::motionAt(float t) {
+    SMotion motion;
+    switch (mScenario) {
+        case EDriveScenario::HardLaunch: hardLaunch(t, motion); break;
+        case EDriveScenario::EmergencyBrake: emergencyBrake(t, motion); break;
+        case EDriveScenario::Slalom: slalom(t, motion); break;
+        case EDriveScenario::RumbleStrip: rumbleStrip(t, motion); break;
+        case EDriveScenario::PotholeField: potholeField(motion); break;
+        case EDriveScenario::Jump: jump(t, motion); break;
+        case EDriveScenario::HeliHover: heliHover(t, motion); break;
+        case EDriveScenario::BikeLean: bikeLean(t, motion); break;
+        default: break;
+    }
+    return motion;
+}
+
+// Standing still for a second, then full throttle through the gears.
+void CDriveScenario::hardLaunch(float t, SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    const float launch = t - 1.0f;
+    if (launch < 0.0f) {
+        motion.RPM = 0.2f;
+        return;
+    }
+
+    motion.ForwardSpeed = 50.0f * (1.0f - std::exp(-launch / 3.0f));
+    // Gear changes every 1.3 s
+    const float gear = launch / 1.3f;
+    motion.RPM = 0.4f + 0.6f * (gear - std::floor(gear));
+    // Squat, then settle
+    motion.Pitch = 1.5f * std::exp(-launch / 0.8f) + settle(launch, 0.3f, 0.5f, 0.3f);
+    for (uint8_t i = 2; i < motion.Wheels.Count; ++i) {
+        motion.Wheels.Compression[i] += 0.05f * std::exp(-launch / 0.8f);
+    }
+}
+
+// Cruising at 126 km/h, then braking at 0.97 g to a stop.
+void CDriveScenario::emergencyBrake(float t, SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    constexpr float cruiseSpeed = 35.0f;
+    constexpr float braking = 9.5f;
+    constexpr float brakeStart = 1.5f;
+    constexpr float brakeEnd = brakeStart + cruiseSpeed / braking;
+
+    if (t < brakeStart) {
+        motion.ForwardSpeed = cruiseSpeed;
+        return;
+    }
+    if (t < brakeEnd) {
+        const float braked = t - brakeStart;
+        motion.ForwardSpeed = cruiseSpeed - braking * braked;
+        // Nose dive, building up over 0.15 s
+        motion.Pitch = -2.5f * std::min(braked / 0.15f, 1.0f);
+        for (uint8_t i = 0; i < 2; ++i) {
+            motion.Wheels.Compression[i] += 0.06f;
+        }
+        return;
+    }
+    // Stopped, the body rocks back
+    motion.ForwardSpeed = 0.0f;
+    motion.Pitch = -settle(t - brakeEnd, 2.5f, 0.6f, 0.25f);
+}
+
+// Weaving left and right at 72 km/h, a full cycle every 2.4 s.
+void CDriveScenario::slalom(float t, SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    const float phase = twoPi * t / 2.4f;
+    motion.ForwardSpeed = 20.0f;
+    motion.YawRate = 0.7f * std::sin(phase);
+    // Body roll and slip lag the steering a little
+    motion.Roll = -3.5f * std::sin(phase - 0.3f);
+    motion.SideSpeed = -0.4f * std::sin(phase - 0.3f);
+    for (uint8_t i = 0; i < motion.Wheels.Count; ++i) {
+        const float side = i % 2 == 0 ? 1.0f : -1.0f;
+        motion.Wheels.Compression[i] += side * 0.03f * std::sin(phase - 0.3f);
+    }
+}
+
+// Right wheels on a rumble strip for three seconds, at 90 km/h.
+void CDriveScenario::rumbleStrip(float t, SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    motion.ForwardSpeed = 25.0f;
+    if (t < 1.5f || t > 4.5f) {
+        return;
+    }
+    for (uint8_t i = 1; i < motion.Wheels.Count; i += 2) {
+        const float wheelDistance = mDistance - (i >= 2 ? carWheelbase : 0.0f);
+        // Ridges every 30 cm
+        motion.Wheels.Compression[i] += 0.04f * std::abs(std::sin(static_cast<float>(M_PI) * wheelDistance / 0.3f));
+        motion.Wheels.Material[i] = material(eMaterial::RUMBLE_STRIP);
+    }
+    motion.Roll = 0.3f * std::sin(static_cast<float>(M_PI) * mDistance / 0.3f);
+}
+
+// One pothole about every 6 m, on the left, right or both sides, at 54 km/h.
+void CDriveScenario::potholeField(SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    motion.ForwardSpeed = 15.0f;
+
+    constexpr float spacing = 6.0f;
+    float leftDrop = 0.0f;
+    float rightDrop = 0.0f;
+    for (uint8_t i = 0; i < motion.Wheels.Count; ++i) {
+        const float wheelDistance = mDistance - (i >= 2 ? carWheelbase : 0.0f);
+        const auto cell = static_cast<int32_t>(std::floor(wheelDistance / spacing));
+        const float start = static_cast<float>(cell) * spacing + 4.0f * hash01(cell, 1);
+        const float length = 0.5f + 0.4f * hash01(cell, 2);
+        const int sides = static_cast<int>(3.0f * hash01(cell, 3));
+        const bool left = i % 2 == 0;
+        const bool onSide = sides == 2 || (sides == 0) == left;
+
+        const float into = wheelDistance - start;
+        if (!onSide || into < 0.0f || into > length + 0.3f) {
+            continue;
+        }
+        motion.Wheels.Material[i] = material(eMaterial::TARMAC_POTHOLE);
+        // Drops in, then hits the far edge
+        const float compression = into < length ? -0.08f : 0.18f;
+        motion.Wheels.Compression[i] += compression;
+        (left ? leftDrop : rightDrop) += compression;
+    }
+    motion.Roll = 4.0f * (rightDrop - leftDrop);
+    motion.Pitch = 2.0f * (motion.Wheels.Compression[0] + motion.Wheels.Compression[1] -
+        motion.Wheels.Compression[2] - motion.Wheels.Compression[3]);
+}
+
+// Up a ramp at 108 km/h, airborne for about a second, and landing.
+void CDriveScenario::jump(float t, SMotion& motion) {
+    constexpr float rampStart = 1.6f;
+    constexpr float rampEnd = 2.0f;
+    constexpr float rampPitch = 10.0f;
+    motion.ForwardSpeed = 30.0f;
+
+    if (t < rampStart) {
+        fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+        return;
+    }
+
+    if (t < rampEnd) {
+        const float ramp = (t - rampStart) / (rampEnd - rampStart);
+        motion.Pitch = rampPitch * ramp;
+        mVerticalSpeed = motion.ForwardSpeed * std::sin(deg2rad(motion.Pitch));
+        fillWheels(motion, restCompression + 0.1f * ramp, material(eMaterial::TARMAC));
+    }
+    else if (mLandingTime < 0.0f) {
+        if (mTakeoffTime < 0.0f) {
+            mTakeoffTime = t;
+        }
+        mVerticalSpeed -= gravity * mFrameTime;
+        if (mHeight + mVerticalSpeed * mFrameTime <= 0.0f) {
+            mLandingTime = t;
+        }
+        // Nose drops slowly in the air
+        motion.Pitch = rampPitch - 8.0f * (t - mTakeoffTime);
+        fillWheels(motion, 0.0f, material(eMaterial::TARMAC));
+    }
+
+    if (mLandingTime >= 0.0f) {
+        const float landed = t - mLandingTime;
+        mVerticalSpeed = 0.0f;
+        mHeight = 0.0f;
+        motion.Pitch = settle(landed, -3.0f, 0.5f, 0.2f);
+        fillWheels(motion, restCompression + 0.3f * std::exp(-landed / 0.15f), material(eMaterial::TARMAC));
+    }
+
+    mHeight = std::max(0.0f, mHeight + mVerticalSpeed * mFrameTime);
+    motion.VerticalSpeed = mVerticalSpeed;
+}
+
+// Holding position in the air, drifting and correcting.
+void CDriveScenario::heliHover(float t, SMotion& motion) const {
+    motion.Wheels.Count = 0;
+    motion.RPM = 1.0f;
+    motion.ForwardSpeed = 0.8f * std::sin(0.4f * t);
+    motion.SideSpeed = 0.5f * std::sin(0.27f * t + 1.0f);
+    motion.VerticalSpeed = 0.4f * std::sin(0.9f * t);
+    motion.YawRate = 0.15f * std::sin(0.3f * t);
+    // Tilting into the drift
+    motion.Pitch = -2.0f * std::sin(0.4f * t + 0.5f);
+    motion.Roll = 2.5f * std::sin(0.27f * t + 1.5f);
+}
+
+// Sweeping curves at 80 km/h, leaning into each one.
+void CDriveScenario::bikeLean(float t, SMotion& motion) const {
+    fillWheels(motion, restCompression, material(eMaterial::TARMAC));
+    motion.ForwardSpeed = 22.0f;
+    motion.YawRate = 0.35f * std::sin(twoPi * t / 5.0f);
+    // Balanced lean angle for the turn
+    motion.Roll = -rad2deg(std::atan(motion.ForwardSpeed * motion.YawRate / gravity));
+}
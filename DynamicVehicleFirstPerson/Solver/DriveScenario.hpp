@@ -0,0 +1,94 @@
+#pragma once
+#include "CameraSolver.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+enum class EDriveScenario : uint8_t {
+    HardLaunch,
+    EmergencyBrake,
+    Slalom,
+    RumbleStrip,
+    PotholeField,
+    Jump,
+    HeliHover,
+    BikeLean,
+    Count
+};
+
+// Synthesizes the vehicle state of a scripted drive, frame by frame, filled
+// into SCameraSolverInput the way the script fills it from natives. Speed
+// vector and accelerations are derived from the simulated motion like
+// CVehicleMetaData does, so they carry the same frame-to-frame noise.
+// The same scenario and frame rate always give the same frames.
+class CDriveScenario {
+public:
+    // duration in seconds, 0 for the scenario's default.
+    CDriveScenario(EDriveScenario scenario, float frameRate, float duration = 0.0f);
+
+    static const char* Name(EDriveScenario scenario);
+    static bool FromName(std::string_view name, EDriveScenario& scenario);
+    // Seconds
+    static float DefaultDuration(EDriveScenario scenario);
+
+    EDriveScenario Scenario() const { return mScenario; }
+    uint32_t FrameCount() const { return mFrameCount; }
+
+    // Fills the vehicle state and the frame time. Camera, Look, ShakeData and
+    // the look controls are left as they are, so the caller sets them once.
+    // Returns false after the last frame.
+    bool Next(SCameraSolverInput& input);
+
+    // Back to the first frame.
+    void Rewind();
+
+private:
+    // What the scenario drives, before it's turned into solver input.
+    struct SMotion {
+        // Relative to the vehicle heading, m/s
+        float ForwardSpeed = 0.0f;
+        float SideSpeed = 0.0f;
+        // World, m/s. Only used while airborne or flying.
+        float VerticalSpeed = 0.0f;
+        // Radians per second
+        float YawRate = 0.0f;
+        // Degrees
+        float Pitch = 0.0f;
+        float Roll = 0.0f;
+        // Negative: derived from speed
+        float RPM = -1.0f;
+        VehicleExtensions::SWheelData Wheels;
+    };
+
+    void setupVehicle(SCameraSolverInput& input) const;
+    void fillWheels(SMotion& motion, float compression, uint16_t material) const;
+    SMotion motionAt(float t);
+
+    void hardLaunch(float t, SMotion& motion) const;
+    void emergencyBrake(float t, SMotion& motion) const;
+    void slalom(float t, SMotion& motion) const;
+    void rumbleStrip(float t, SMotion& motion) const;
+    void potholeField(SMotion& motion) const;
+    void jump(float t, SMotion& motion);
+    void heliHover(float t, SMotion& motion) const;
+    void bikeLean(float t, SMotion& motion) const;
+
+    EDriveScenario mScenario;
+    float mFrameTime;
+    uint32_t mFrameCount;
+    uint32_t mFrame = 0;
+
+    // Simulated state
+    float mDistance = 0.0f;
+    float mHeight = 0.0f;
+    float mVerticalSpeed = 0.0f;
+    // Seconds, negative while not airborne yet
+    float mTakeoffTime = -1.0f;
+    float mLandingTime = -1.0f;
+    // Degrees
+    float mYaw = 0.0f;
+    float mPrevPitch = 0.0f;
+    float mPrevRoll = 0.0f;
+    SVector3 mPrevWorldVelocity{};
+    SVector3 mPrevSpeedVector{};
+};
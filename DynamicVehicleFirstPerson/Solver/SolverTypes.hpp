@@ -0,0 +1,25 @@
+#pragma once
+
+// Plain types shared between the camera solver and the script.
+// Nothing in Solver/ may depend on Windows or ScriptHookV headers.
+
+// Same layout as the game's Vector3, without the padding.
+struct SVector3 {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+enum class ESeatPosition {
+    Left,
+    Center,
+    Right
+};
+
+// Where the look input comes from this frame.
+enum class ELookInput {
+    Controller,
+    Mouse,
+    // Manual Transmission wheel buttons
+    Wheel,
+};
@@ -0,0 +1,20 @@
+#include "FrameClock.hpp"
+
+#include "../Memory/MemoryAccess.hpp"
+
+#include <inc/natives.h>
+
+void CFrameClock::Tick() {
+    ++mFrame;
+    mDelta = sampleDelta();
+    mTimeScale = sampleTimeScale();
+    mTime += mDelta;
+}
+
+float CGameFrameClock::sampleDelta() const {
+    return MISC::GET_FRAME_TIME();
+}
+
+float CGameFrameClock::sampleTimeScale() const {
+    return Memory::GetTimeScale();
+}
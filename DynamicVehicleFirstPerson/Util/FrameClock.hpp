@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+
+// Frame timing, sampled once at the start of each tick. Everything in the
+// tick reads the same values from here instead of asking the game again.
+// CGameFrameClock reads the game, CFixedFrameClock lets a harness set the
+// frame time, e.g. to check the camera behaves the same at any frame rate.
+class CFrameClock {
+public:
+    virtual ~CFrameClock() = default;
+
+    // Call once per tick, before anything reads the clock.
+    void Tick();
+
+    // Ticks since the clock was created, 1 during the first tick.
+    uint64_t Frame() const { return mFrame; }
+    // Seconds since the previous tick
+    float Delta() const { return mDelta; }
+    float TimeScale() const { return mTimeScale; }
+    // Seconds, sum of all deltas
+    double Time() const { return mTime; }
+
+protected:
+    virtual float sampleDelta() const = 0;
+    virtual float sampleTimeScale() const { return 1.0f; }
+
+    uint64_t mFrame = 0;
+    float mDelta = 0.0f;
+    float mTimeScale = 1.0f;
+    double mTime = 0.0;
+};
+
+// MISC::GET_FRAME_TIME and the game's time scale.
+class CGameFrameClock : public CFrameClock {
+protected:
+    float sampleDelta() const override;
+    float sampleTimeScale() const override;
+};
+
+class CFixedFrameClock : public CFrameClock {
+public:
+    explicit CFixedFrameClock(float delta, float timeScale = 1.0f)
+        : mFixedDelta(delta)
+        , mFixedTimeScale(timeScale) {
+    }
+
+    // Used from the next Tick() on.
+    void SetDelta(float delta) { mFixedDelta = delta; }
+    void SetTimeScale(float timeScale) { mFixedTimeScale = timeScale; }
+
+protected:
+    float sampleDelta() const override { return mFixedDelta; }
+    float sampleTimeScale() const override { return mFixedTimeScale; }
+
+    float mFixedDelta;
+    float mFixedTimeScale;
+};
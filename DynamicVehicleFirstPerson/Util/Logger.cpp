@@ -3,11 +3,15 @@
 #include <chrono>
 #include <format>
 #include <fstream>
+#include <thread>
 #include <vector>
 
 Logger g_Logger;
 
 namespace {
+    // How long the writer sleeps between batches, unless woken by an error.
+    constexpr auto writerInterval = std::chrono::milliseconds(50);
+
     constexpr const char* const levelStrings[] = {
         " DEBUG ",
         " INFO  ",
@@ -42,17 +46,92 @@ void Logger::ClearError() {
     mError = false;
 }
 
-void Logger::write(LogLevel level, const std::string& txt) const {
-#ifndef _DEBUG
-    if (level < minLevel) return;
-#endif
-    std::ofstream logFile(file, std::ios_base::out | std::ios_base::app);
+void Logger::Start() {
+    if (mRunning.exchange(true)) {
+        return;
+    }
+    mStopRequested = false;
+    mWriterDone = false;
+
+    // Detached: DllMain can't join it under the loader lock.
+    std::thread(&Logger::writerLoop, this).detach();
+}
+
+void Logger::Shutdown(bool processTerminating) {
+    if (mRunning.exchange(false)) {
+        mStopRequested = true;
+        mWake.notify_one();
+
+        if (!processTerminating) {
+            // Give it a moment to finish its last batch, so it's not inside our code on unload.
+            for (int i = 0; i < 20 && !mWriterDone; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+    flushQueue();
+}
+
+void Logger::write(LogLevel level, std::string txt) const {
+    SEntry entry{
+        .Level = level,
+        .Time = std::chrono::system_clock::now(),
+        .Text = std::move(txt),
+    };
+
+    if (!mQueue.TryPush(std::move(entry))) {
+        ++mDropped;
+        return;
+    }
+
+    if (!mRunning) {
+        flushQueue();
+    }
+    else if (level >= ERROR || mQueue.SizeApprox() > queueSize / 2) {
+        mWake.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    while (!mStopRequested) {
+        {
+            std::unique_lock lock(mWakeMutex);
+            mWake.wait_for(lock, writerInterval, [this]() { return mStopRequested.load(); });
+        }
+        flushQueue();
+    }
+    mWriterDone = true;
+}
+
+void Logger::flushQueue() const {
+    std::unique_lock lock(mFileMutex, std::defer_lock);
+    // Not getting it means the writer died holding it, so there's nobody to race with.
+    (void)lock.try_lock_for(std::chrono::milliseconds(200));
 
-    const auto now = std::chrono::system_clock::now().time_since_epoch();
-    logFile << std::format("[{:%H:%M:%S}] [{}] {}\n",
-        std::chrono::duration_cast<std::chrono::milliseconds>(now),
-        levelText(level),
-        txt);
+    std::string batch;
+    SEntry entry;
+    while (mQueue.TryPop(entry)) {
+        batch += std::format("[{:%H:%M:%S}] [{}] {}\n",
+            std::chrono::duration_cast<std::chrono::milliseconds>(entry.Time.time_since_epoch()),
+            levelText(entry.Level),
+            entry.Text);
+    }
+
+    uint32_t dropped = mDropped.exchange(0);
+    if (dropped > 0) {
+        batch += std::format("[{:%H:%M:%S}] [{}] Log queue full, dropped {} messages\n",
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()),
+            levelText(WARN),
+            dropped);
+    }
+
+    if (batch.empty()) {
+        return;
+    }
+
+    std::ofstream logFile(file, std::ios_base::out | std::ios_base::app);
+    logFile << batch;
 
     logFile.close();
     if (logFile.fail())
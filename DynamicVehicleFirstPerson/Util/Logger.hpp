@@ -1,9 +1,30 @@
 #pragma once
+#include "RingBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <format>
+#include <mutex>
 #include <string>
 
+// Messages below this level are compiled out. Defaults to everything in
+// debug builds and INFO and up in release builds.
+#ifndef LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define LOG_MIN_LEVEL 0 // DEBUG
+#else
+#define LOG_MIN_LEVEL 1 // INFO
+#endif
+#endif
+
+// The level checks happen before the arguments are evaluated or formatted,
+// so a filtered message only costs a comparison.
 #define LOG(level, fmt, ...) \
-    g_Logger.Write(level, fmt, __VA_ARGS__)
+    do { \
+        if ((level) >= LOG_MIN_LEVEL && g_Logger.ShouldLog(level)) \
+            g_Logger.Write(level, fmt, ##__VA_ARGS__); \
+    } while (0)
 
 enum LogLevel {
     DEBUG,
@@ -19,10 +40,22 @@ public:
     Logger();
     void SetFile(const std::string& fileName);
     void SetMinLevel(LogLevel level);
+    bool ShouldLog(LogLevel level) const {
+        return level >= minLevel;
+    }
     void Clear() const;
     bool Error();
     void ClearError();
 
+    // Hands writing off to a background thread, which writes in batches.
+    // Until then, and after Shutdown, every message is written immediately.
+    void Start();
+
+    // Writes everything that's still queued. Safe to call from DllMain,
+    // as it doesn't join the writer thread. The thread is already gone
+    // if the process is terminating, so it's not waited for either.
+    void Shutdown(bool processTerminating);
+
     template <typename... Args>
     void Write(LogLevel level, std::string_view fmt, Args&&... args) const {
         try {
@@ -34,12 +67,34 @@ public:
     }
 
 private:
+    struct SEntry {
+        LogLevel Level = INFO;
+        std::chrono::system_clock::time_point Time;
+        std::string Text;
+    };
+
+    // Messages beyond this are dropped (and counted) instead of blocking the game.
+    static constexpr size_t queueSize = 4096;
+
     std::string levelText(LogLevel level) const;
-    void write(LogLevel, const std::string& txt) const;
+    void write(LogLevel, std::string txt) const;
+    void writerLoop();
+    void flushQueue() const;
 
-    mutable bool mError = false;
+    mutable std::atomic<bool> mError = false;
     std::string file = "";
     LogLevel minLevel = INFO;
+
+    mutable CRingBuffer<SEntry, queueSize> mQueue;
+    mutable std::atomic<uint32_t> mDropped = 0;
+
+    std::atomic<bool> mRunning = false;
+    std::atomic<bool> mStopRequested = false;
+    std::atomic<bool> mWriterDone = false;
+    mutable std::mutex mWakeMutex;
+    mutable std::condition_variable mWake;
+    // Timed, so Shutdown can't hang on a writer that was killed mid-write.
+    mutable std::timed_mutex mFileMutex;
 };
 
 extern Logger g_Logger;
@@ -0,0 +1,51 @@
+#include "MappedFile.hpp"
+
+#include <Windows.h>
+
+CMappedFile::~CMappedFile() {
+    Close();
+}
+
+bool CMappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    // The mapping keeps its own reference, so the file handle isn't needed after this.
+    LARGE_INTEGER size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mMapping = mapping;
+    mData = static_cast<const char*>(view);
+    mSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void CMappedFile::Close() {
+    if (mData != nullptr) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping != nullptr) {
+        CloseHandle(mMapping);
+    }
+    mMapping = nullptr;
+    mData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+
+// Read-only view of a whole file. The file can't be replaced while it's open.
+class CMappedFile {
+public:
+    CMappedFile() = default;
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    // Returns false if the file can't be opened or is empty.
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    const char* Data() const { return mData; }
+    size_t Size() const { return mSize; }
+
+private:
+    // HANDLE, kept out of the header so it doesn't need Windows.h
+    void* mMapping = nullptr;
+    const char* mData = nullptr;
+    size_t mSize = 0;
+};
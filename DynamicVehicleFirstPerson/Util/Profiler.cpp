@@ -0,0 +1,120 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+static_assert(CProfiler::StageCount <= 32, "Recorded stages are a 32-bit mask");
+
+const char* CProfiler::StageName(EProfileStage stage) {
+    switch (stage) {
+        case EProfileStage::ScriptTick: return "Script";
+        case EProfileStage::MenuTick:   return "Menu";
+        case EProfileStage::Input:      return "Input";
+        case EProfileStage::Inertia:    return "Inertia";
+        case EProfileStage::Shake:      return "Shake";
+        case EProfileStage::DoF:        return "DoF";
+        case EProfileStage::Attach:     return "Attach/rot";
+        default:                        return "Unknown";
+    }
+}
+
+void CProfiler::SetEnabled(bool enable) {
+    if (enable && !mEnabled) {
+        clear();
+    }
+    mEnabled = enable;
+}
+
+void CProfiler::BeginFrame() {
+    if (!mEnabled) {
+        return;
+    }
+    mCurrent = (mCurrent + 1) % WindowSize;
+    mFrames[mCurrent] = {};
+    mFrameCount = std::min(mFrameCount + 1, WindowSize);
+}
+
+void CProfiler::Record(EProfileStage stage, clock::duration duration) {
+    auto index = static_cast<size_t>(stage);
+    if (!mEnabled || mFrameCount == 0 || index >= StageCount) {
+        return;
+    }
+    SFrame& frame = mFrames[mCurrent];
+    frame.Nanoseconds[index] += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    frame.Recorded |= 1u << index;
+}
+
+CProfiler::SStats CProfiler::Stats(EProfileStage stage) const {
+    auto index = static_cast<size_t>(stage);
+    SStats stats;
+    if (index >= StageCount) {
+        return stats;
+    }
+
+    std::array<int64_t, WindowSize> samples;
+    size_t count = 0;
+    int64_t sum = 0;
+    // Frames that aren't used yet have nothing recorded.
+    for (const SFrame& frame : mFrames) {
+        if (frame.Recorded & (1u << index)) {
+            samples[count++] = frame.Nanoseconds[index];
+            sum += frame.Nanoseconds[index];
+        }
+    }
+
+    if (count == 0) {
+        return stats;
+    }
+
+    // Rounded up, so small windows report their worst frame instead of a random one.
+    size_t p99Index = (count * 99 + 99) / 100 - 1;
+    std::nth_element(samples.begin(), samples.begin() + p99Index, samples.begin() + count);
+    auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.begin() + count);
+
+    stats.Min = static_cast<double>(*minIt) / 1000.0;
+    stats.Max = static_cast<double>(*maxIt) / 1000.0;
+    stats.P99 = static_cast<double>(samples[p99Index]) / 1000.0;
+    stats.Avg = static_cast<double>(sum) / static_cast<double>(count) / 1000.0;
+    stats.Samples = count;
+    return stats;
+}
+
+bool CProfiler::WriteCsv(const std::filesystem::path& csvFile) const {
+    std::error_code ec;
+    if (csvFile.has_parent_path()) {
+        std::filesystem::create_directories(csvFile.parent_path(), ec);
+    }
+
+    std::ofstream file(csvFile);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "frame";
+    for (size_t stage = 0; stage < StageCount; ++stage) {
+        file << ',' << StageName(static_cast<EProfileStage>(stage)) << "_us";
+    }
+    file << '\n';
+
+    // The oldest frame is right after the current one once the window is full.
+    size_t first = mFrameCount < WindowSize ? 1 : (mCurrent + 1) % WindowSize;
+    for (size_t i = 0; i < mFrameCount; ++i) {
+        const SFrame& frame = mFrames[(first + i) % WindowSize];
+        file << i;
+        for (size_t stage = 0; stage < StageCount; ++stage) {
+            file << ',';
+            if (frame.Recorded & (1u << stage)) {
+                file << static_cast<double>(frame.Nanoseconds[stage]) / 1000.0;
+            }
+        }
+        file << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+void CProfiler::clear() {
+    mFrames.fill({});
+    mCurrent = 0;
+    mFrameCount = 0;
+}
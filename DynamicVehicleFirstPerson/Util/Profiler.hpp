@@ -0,0 +1,97 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+// Parts of the script tick that are timed. Nested stages are included
+// in their parents: Input, Inertia, Shake, DoF and Attach are part of ScriptTick.
+enum class EProfileStage {
+    ScriptTick,
+    MenuTick,
+    Input,
+    Inertia,
+    Shake,
+    DoF,
+    Attach,
+    Count
+};
+
+// Opt-in timing of the script tick, kept over the last WindowSize frames.
+// Doesn't depend on the game, so the camera solver can report to it too.
+class CProfiler {
+public:
+    using clock = std::chrono::high_resolution_clock;
+
+    static constexpr size_t WindowSize = 512;
+    static constexpr size_t StageCount = static_cast<size_t>(EProfileStage::Count);
+
+    struct SStats {
+        // Microseconds, over the frames the stage ran in.
+        double Min = 0.0;
+        double Avg = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+        size_t Samples = 0;
+    };
+
+    // Times a scope. Does nothing without a profiler, or when it's disabled.
+    class CScope {
+    public:
+        CScope(CProfiler* profiler, EProfileStage stage)
+            : mProfiler(profiler && profiler->Enabled() ? profiler : nullptr)
+            , mStage(stage) {
+            if (mProfiler) {
+                mStart = clock::now();
+            }
+        }
+
+        ~CScope() {
+            if (mProfiler) {
+                mProfiler->Record(mStage, clock::now() - mStart);
+            }
+        }
+
+        CScope(const CScope&) = delete;
+        CScope& operator=(const CScope&) = delete;
+
+    private:
+        CProfiler* mProfiler;
+        EProfileStage mStage;
+        clock::time_point mStart;
+    };
+
+    static const char* StageName(EProfileStage stage);
+
+    // Clears the window when enabling, so old frames don't skew the stats.
+    void SetEnabled(bool enable);
+    bool Enabled() const { return mEnabled; }
+
+    // Starts a new frame, overwriting the oldest one in the window.
+    void BeginFrame();
+
+    // Adds to the stage's time in the current frame.
+    void Record(EProfileStage stage, clock::duration duration);
+
+    SStats Stats(EProfileStage stage) const;
+
+    // Per-frame times in microseconds, oldest frame first.
+    // Empty cells for stages that didn't run in that frame.
+    bool WriteCsv(const std::filesystem::path& csvFile) const;
+
+private:
+    struct SFrame {
+        std::array<int64_t, StageCount> Nanoseconds{};
+        // Bit per stage that ran this frame
+        uint32_t Recorded = 0;
+    };
+
+    void clear();
+
+    bool mEnabled = false;
+    std::array<SFrame, WindowSize> mFrames{};
+    // Index of the current frame
+    size_t mCurrent = 0;
+    // Frames in the window, up to WindowSize
+    size_t mFrameCount = 0;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free multi-producer/multi-consumer queue (Dmitry Vyukov's design).
+// Each cell has a sequence number that tells producers and consumers whose turn it is,
+// so neither side ever blocks: a full or empty queue just makes TryPush/TryPop fail.
+template <typename T, size_t Capacity>
+class CRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+        "Capacity must be a power of 2");
+
+public:
+    CRingBuffer()
+        : mCells(std::make_unique<SCell[]>(Capacity)) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            mCells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    CRingBuffer(const CRingBuffer&) = delete;
+    CRingBuffer& operator=(const CRingBuffer&) = delete;
+
+    bool TryPush(T&& value) {
+        SCell* cell;
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &mCells[pos & (Capacity - 1)];
+            size_t seq = cell->Sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                // Full
+                return false;
+            }
+            else {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->Data = std::move(value);
+        cell->Sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPop(T& value) {
+        SCell* cell;
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &mCells[pos & (Capacity - 1)];
+            size_t seq = cell->Sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                // Empty
+                return false;
+            }
+            else {
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->Data);
+        cell->Sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate, only meant for heuristics.
+    size_t SizeApprox() const {
+        size_t enqueued = mEnqueuePos.load(std::memory_order_relaxed);
+        size_t dequeued = mDequeuePos.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct SCell {
+        std::atomic<size_t> Sequence;
+        T Data;
+    };
+
+    std::unique_ptr<SCell[]> mCells;
+    alignas(64) std::atomic<size_t> mEnqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> mDequeuePos{ 0 };
+};
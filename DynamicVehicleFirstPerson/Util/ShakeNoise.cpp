@@ -0,0 +1,159 @@
+#include "ShakeNoise.hpp"
+
+#include <xmmintrin.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    // Ken Perlin's reference permutation.
+    constexpr uint8_t permutation[256] = {
+        151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+        140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+        247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+         57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+         74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+         60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+         65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+        200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+         52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+        207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+        119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+        129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+         81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+        184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+        222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+    };
+
+    // std::floor is a library call without SSE4.1, and this runs a few times per sample.
+    int64_t fastFloor(double value) {
+        int64_t truncated = static_cast<int64_t>(value);
+        return value < static_cast<double>(truncated) ? truncated - 1 : truncated;
+    }
+
+    int perm(int i) {
+        return permutation[i & 255];
+    }
+
+    // grad() of the reference implementation as a gradient vector per hash,
+    // so it becomes a dot product: gx * x + gy * y + gz * z.
+    struct SGradient {
+        float X;
+        float Y;
+        float Z;
+    };
+
+    constexpr std::array<SGradient, 16> makeGradients() {
+        std::array<SGradient, 16> gradients{};
+        for (int h = 0; h < 16; ++h) {
+            float g[3] = {};
+            // u
+            g[h < 8 ? 0 : 1] += (h & 1) == 0 ? 1.0f : -1.0f;
+            // v
+            int v = h < 4 ? 1 : (h == 12 || h == 14) ? 0 : 2;
+            g[v] += (h & 2) == 0 ? 1.0f : -1.0f;
+            gradients[h] = { g[0], g[1], g[2] };
+        }
+        return gradients;
+    }
+
+    constexpr std::array<SGradient, 16> gradients = makeGradients();
+
+    float fade(float t) {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+
+    __m128 fade(__m128 t) {
+        __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))),
+            _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    __m128 lerp(__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    // Gradient dot offset for one corner, with a hash per lane.
+    __m128 grad(const int (&hash)[4], float x, float y, __m128 z) {
+        const SGradient& g0 = gradients[hash[0] & 15];
+        const SGradient& g1 = gradients[hash[1] & 15];
+        const SGradient& g2 = gradients[hash[2] & 15];
+        const SGradient& g3 = gradients[hash[3] & 15];
+        __m128 gx = _mm_setr_ps(g0.X, g1.X, g2.X, g3.X);
+        __m128 gy = _mm_setr_ps(g0.Y, g1.Y, g2.Y, g3.Y);
+        __m128 gz = _mm_setr_ps(g0.Z, g1.Z, g2.Z, g3.Z);
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, _mm_set1_ps(x)), _mm_mul_ps(gy, _mm_set1_ps(y))),
+            _mm_mul_ps(gz, z));
+    }
+}
+
+CShakeNoise::CShakeNoise(double sideOffset, double vertOffset, double rollOffset)
+    : mOffsets{ sideOffset, vertOffset, rollOffset } {
+}
+
+CShakeNoise::SSample CShakeNoise::Sample(double time) const {
+    const double xd = std::cos(time);
+    const double yd = std::sin(time);
+    const int64_t xFloor = fastFloor(xd);
+    const int64_t yFloor = fastFloor(yd);
+
+    // Shared by all channels
+    const int X = static_cast<int>(xFloor & 255);
+    const int Y = static_cast<int>(yFloor & 255);
+    const float x = static_cast<float>(xd - static_cast<double>(xFloor));
+    const float y = static_cast<float>(yd - static_cast<double>(yFloor));
+    const int A = perm(X) + Y;
+    const int B = perm(X + 1) + Y;
+
+    // The noise repeats every 256 units, so only the wrapped cell index is kept
+    // and the fraction is taken while still in double. Time keeps growing,
+    // and float would lose the fraction after a while.
+    int Z[4] = {};
+    float z[4] = {};
+    for (int i = 0; i < 3; ++i) {
+        const double zd = mOffsets[i] + time;
+        const int64_t zFloor = fastFloor(zd);
+        Z[i] = static_cast<int>(zFloor & 255);
+        z[i] = static_cast<float>(zd - static_cast<double>(zFloor));
+    }
+
+    // Corner hashes, one lane per channel. Lane 3 is padding.
+    int hAA[4], hBA[4], hAB[4], hBB[4];
+    int hAA1[4], hBA1[4], hAB1[4], hBB1[4];
+    for (int i = 0; i < 4; ++i) {
+        const int AA = perm(A) + Z[i];
+        const int AB = perm(A + 1) + Z[i];
+        const int BA = perm(B) + Z[i];
+        const int BB = perm(B + 1) + Z[i];
+        hAA[i] = perm(AA);
+        hBA[i] = perm(BA);
+        hAB[i] = perm(AB);
+        hBB[i] = perm(BB);
+        hAA1[i] = perm(AA + 1);
+        hBA1[i] = perm(BA + 1);
+        hAB1[i] = perm(AB + 1);
+        hBB1[i] = perm(BB + 1);
+    }
+
+    const __m128 z0 = _mm_loadu_ps(z);
+    const __m128 z1 = _mm_sub_ps(z0, _mm_set1_ps(1.0f));
+    const __m128 u = _mm_set1_ps(fade(x));
+    const __m128 v = _mm_set1_ps(fade(y));
+    const __m128 w = fade(z0);
+
+    __m128 result = lerp(w,
+        lerp(v,
+            lerp(u, grad(hAA, x, y, z0), grad(hBA, x - 1.0f, y, z0)),
+            lerp(u, grad(hAB, x, y - 1.0f, z0), grad(hBB, x - 1.0f, y - 1.0f, z0))),
+        lerp(v,
+            lerp(u, grad(hAA1, x, y, z1), grad(hBA1, x - 1.0f, y, z1)),
+            lerp(u, grad(hAB1, x, y - 1.0f, z1), grad(hBB1, x - 1.0f, y - 1.0f, z1))));
+
+    // (result + 1) / 2 - 0.5
+    result = _mm_mul_ps(result, _mm_set1_ps(0.5f));
+
+    float out[4];
+    _mm_storeu_ps(out, result);
+    return { out[0], out[1], out[2] };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Improved Perlin noise (same permutation and gradients as thirdparty/Perlin_Noise),
+// specialized for the camera shake: three channels that walk a circle in xy and
+// only differ in their z offset. The xy part is shared and the channels are
+// evaluated together in float SSE lanes, instead of three separate double calls.
+class CShakeNoise {
+public:
+    // Centered around 0, in [-0.5, 0.5] like PerlinNoise::noise() - 0.5.
+    struct SSample {
+        float Side;
+        float Vert;
+        float Roll;
+    };
+
+    CShakeNoise(double sideOffset, double vertOffset, double rollOffset);
+
+    // Samples at (cos(time), sin(time), offset + time) for each channel.
+    SSample Sample(double time) const;
+
+private:
+    double mOffsets[3];
+};
@@ -0,0 +1,167 @@
+#include "Tracing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    const clock::time_point traceEpoch = clock::now();
+    std::atomic<bool> enabled = false;
+
+    // Fields are atomic so a flush can read a buffer while its thread writes to it.
+    // Relaxed loads and stores are plain moves on x64.
+    struct SEvent {
+        std::atomic<const char*> Name{ nullptr };
+        std::atomic<int64_t> Begin{ 0 };
+        std::atomic<int64_t> End{ 0 };
+    };
+
+    // Written only by its own thread. Head counts every event ever written,
+    // the slot is Head % BufferSize.
+    struct SThreadBuffer {
+        uint32_t ThreadId = 0;
+        std::atomic<uint64_t> Head{ 0 };
+        // Events before this were dropped by Clear()
+        std::atomic<uint64_t> Tail{ 0 };
+        std::array<SEvent, Tracing::BufferSize> Events;
+    };
+
+    // Only locked to register a new thread, and to flush or clear.
+    // Buffers outlive their threads, so a flush still sees their zones.
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<SThreadBuffer>> buffers;
+
+    SThreadBuffer& getThreadBuffer() {
+        thread_local SThreadBuffer* threadBuffer = nullptr;
+        if (!threadBuffer) {
+            auto buffer = std::make_unique<SThreadBuffer>();
+            std::lock_guard lock(buffersMutex);
+            buffer->ThreadId = static_cast<uint32_t>(buffers.size()) + 1;
+            threadBuffer = buffer.get();
+            buffers.push_back(std::move(buffer));
+        }
+        return *threadBuffer;
+    }
+
+    int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - traceEpoch).count();
+    }
+
+    void writeJsonString(std::ofstream& file, const char* text) {
+        file << '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                file << '\\';
+            }
+            file << *c;
+        }
+        file << '"';
+    }
+}
+
+void Tracing::SetEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool Tracing::Enabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Tracing::Clear() {
+    std::lock_guard lock(buffersMutex);
+    for (auto& buffer : buffers) {
+        buffer->Tail.store(buffer->Head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool Tracing::WriteChromeTrace(const std::filesystem::path& jsonFile) {
+    std::error_code ec;
+    if (jsonFile.has_parent_path()) {
+        std::filesystem::create_directories(jsonFile.parent_path(), ec);
+    }
+
+    std::ofstream file(jsonFile);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Chrome wants microseconds, nanoseconds are kept as decimals.
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard lock(buffersMutex);
+    for (auto& buffer : buffers) {
+        const uint64_t head = buffer->Head.load(std::memory_order_acquire);
+        const uint64_t tail = buffer->Tail.load(std::memory_order_relaxed);
+        uint64_t begin = std::max(tail, head > BufferSize ? head - BufferSize : 0);
+
+        struct SCopy {
+            const char* Name;
+            int64_t Begin;
+            int64_t End;
+        };
+        std::vector<SCopy> events;
+        events.reserve(head - begin);
+        for (uint64_t i = begin; i < head; ++i) {
+            const SEvent& event = buffer->Events[i % BufferSize];
+            events.push_back({
+                event.Name.load(std::memory_order_relaxed),
+                event.Begin.load(std::memory_order_relaxed),
+                event.End.load(std::memory_order_relaxed),
+            });
+        }
+
+        // The thread may have kept writing while copying. Skip the slots it
+        // overwrote, including the one it might be writing right now.
+        const uint64_t newHead = buffer->Head.load(std::memory_order_acquire);
+        const uint64_t firstValid = newHead + 1 > BufferSize ? newHead + 1 - BufferSize : 0;
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(
+            firstValid > begin ? firstValid - begin : 0, events.size()));
+
+        for (size_t i = skip; i < events.size(); ++i) {
+            const SCopy& event = events[i];
+            if (!event.Name) {
+                continue;
+            }
+            file << (first ? "\n" : ",\n");
+            first = false;
+            file << "{\"name\":";
+            writeJsonString(file, event.Name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->ThreadId
+                << ",\"ts\":" << static_cast<double>(event.Begin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(event.End - event.Begin) / 1000.0 << '}';
+        }
+    }
+
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+Tracing::CZone::CZone(const char* name)
+    : mName(name)
+    , mBegin(Enabled() ? now() : -1) {
+}
+
+Tracing::CZone::~CZone() {
+    if (mBegin < 0) {
+        return;
+    }
+    const int64_t end = now();
+
+    SThreadBuffer& buffer = getThreadBuffer();
+    const uint64_t head = buffer.Head.load(std::memory_order_relaxed);
+    SEvent& event = buffer.Events[head % BufferSize];
+    event.Name.store(mName, std::memory_order_relaxed);
+    event.Begin.store(mBegin, std::memory_order_relaxed);
+    event.End.store(end, std::memory_order_relaxed);
+    buffer.Head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Scoped zones for finding slow native calls in a frame.
+// While enabled, each zone records its begin and end time into a ring buffer
+// owned by the calling thread, so recording never takes a lock.
+// Only the last Tracing::BufferSize zones per thread are kept.
+//
+// Usage:
+//     void CFoo::update() {
+//         FPV_TRACE_ZONE("CFoo::update");
+//         ...
+//     }
+//
+// Zone names must be string literals, only the pointer is stored.
+namespace Tracing {
+    constexpr size_t BufferSize = 16384;
+
+    void SetEnabled(bool enable);
+    bool Enabled();
+
+    // Drops all recorded zones.
+    void Clear();
+
+    // Writes the recorded zones as Chrome trace event JSON,
+    // for chrome://tracing or ui.perfetto.dev.
+    bool WriteChromeTrace(const std::filesystem::path& jsonFile);
+
+    class CZone {
+    public:
+        explicit CZone(const char* name);
+        ~CZone();
+
+        CZone(const CZone&) = delete;
+        CZone& operator=(const CZone&) = delete;
+
+    private:
+        const char* mName;
+        // -1 when tracing was disabled at the start of the zone
+        int64_t mBegin;
+    };
+}
+
+#define FPV_TRACE_CONCAT_IMPL(a, b) a##b
+#define FPV_TRACE_CONCAT(a, b) FPV_TRACE_CONCAT_IMPL(a, b)
+#define FPV_TRACE_ZONE(name) Tracing::CZone FPV_TRACE_CONCAT(traceZone_, __LINE__)(name)
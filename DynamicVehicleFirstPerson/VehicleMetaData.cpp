@@ -1,28 +1,83 @@
 #include "VehicleMetaData.hpp"
+#include "Memory/MemoryAccess.hpp"
 #include "Util/Math.hpp"
+#include "Util/Tracing.hpp"
+#include <inc/main.h>
 #include <inc/natives.h>
+#include <unordered_map>
+
+namespace {
+    std::unordered_map<Hash, SModelData> modelDataCache;
+
+    SModelData readModelData(Vehicle vehicle, Hash model) {
+        FPV_TRACE_ZONE("readModelData");
+        SModelData data;
+
+        data.IsBike = VEHICLE::IS_THIS_MODEL_A_BIKE(model) ||
+            VEHICLE::IS_THIS_MODEL_A_QUADBIKE(model) ||
+            VEHICLE::IS_THIS_MODEL_A_BICYCLE(model);
+        data.IsPlane = VEHICLE::IS_THIS_MODEL_A_PLANE(model);
+        data.IsHeli = VEHICLE::IS_THIS_MODEL_A_HELI(model);
+
+        data.DriverSeatBoneIndex = ENTITY::GET_ENTITY_BONE_INDEX_BY_NAME(vehicle, "seat_dside_f");
+        data.CameraSeatBoneIndex = data.IsBike ?
+            ENTITY::GET_ENTITY_BONE_INDEX_BY_NAME(vehicle, "seat_f") :
+            data.DriverSeatBoneIndex;
+
+        int index = 0xFFFF;
+        data.ModelInfo = Memory::GetModelInfo(model, &index);
+        if (data.ModelInfo == 0)
+            return data;
+
+        // Correct offset for <1290 on load
+        // < VER_1_0_1290_1_STEAM
+        const unsigned fpvCamOffsetXOffset = getGameVersion() < 38 ? 0x428 : 0x450;
+
+        // offset from seat?
+        // These offsets don't seem very version-sturdy. Oh well, hope R* doesn't knock em over.
+        data.CamSeatOffset.x = *reinterpret_cast<float*>(data.ModelInfo + fpvCamOffsetXOffset);
+        data.CamSeatOffset.y = *reinterpret_cast<float*>(data.ModelInfo + fpvCamOffsetXOffset + 4);
+        data.CamSeatOffset.z = *reinterpret_cast<float*>(data.ModelInfo + fpvCamOffsetXOffset + 8);
+        data.RollbarOffset = *reinterpret_cast<float*>(data.ModelInfo + fpvCamOffsetXOffset + 0x30);
+        return data;
+    }
+}
 
 CVehicleMetaData::CVehicleMetaData(Vehicle vehicle)
     : mVehicle(vehicle) {
+    FPV_TRACE_ZONE("CVehicleMetaData::CVehicleMetaData");
     if (!ENTITY::DOES_ENTITY_EXIST(vehicle))
         return;
 
     mModel = ENTITY::GET_ENTITY_MODEL(vehicle);
+
+    auto cachedData = modelDataCache.find(mModel);
+    if (cachedData == modelDataCache.end()) {
+        cachedData = modelDataCache.emplace(mModel, readModelData(vehicle, mModel)).first;
+    }
+    mModelData = cachedData->second;
+
     mSeatPosition = getSeatPosition();
     mVelocity = ENTITY::GET_ENTITY_SPEED_VECTOR(mVehicle, true);
 }
 
-void CVehicleMetaData::Update() {
+void CVehicleMetaData::Update(const SVehicleSnapshot& snapshot, float frameTime) {
+    FPV_TRACE_ZONE("CVehicleMetaData::Update");
     // Calculate values based on old values first
-    mAcceleration = calculateAcceleration();
-    mAccelerationCentripetal = calculateAccelerationCentripetal();
+    mAcceleration = calculateAcceleration(snapshot, frameTime);
+    mAccelerationCentripetal = calculateAccelerationCentripetal(snapshot, frameTime);
 
     // Then update values
-    mVelocity = ENTITY::GET_ENTITY_SPEED_VECTOR(mVehicle, true);
-    mWorldVelocity = ENTITY::GET_ENTITY_VELOCITY(mVehicle);
+    UpdateVelocity(snapshot);
+}
+
+void CVehicleMetaData::UpdateVelocity(const SVehicleSnapshot& snapshot) {
+    mVelocity = snapshot.SpeedVector;
+    mWorldVelocity = snapshot.WorldVelocity;
 }
 
 bool CVehicleMetaData::IsDriverWindowPresent() {
+    FPV_TRACE_ZONE("CVehicleMetaData::IsDriverWindowPresent");
     if (mSeatPosition == ESeatPosition::Left) {
         return VEHICLE::IS_VEHICLE_WINDOW_INTACT(mVehicle, 0);
     }
@@ -33,10 +88,11 @@ bool CVehicleMetaData::IsDriverWindowPresent() {
 }
 
 ESeatPosition CVehicleMetaData::getSeatPosition() const {
+    FPV_TRACE_ZONE("CVehicleMetaData::getSeatPosition");
     if (!ENTITY::DOES_ENTITY_EXIST(mVehicle))
         return ESeatPosition::Center;
 
-    int driverSeatBoneIndex = ENTITY::GET_ENTITY_BONE_INDEX_BY_NAME(mVehicle, "seat_dside_f");
+    int driverSeatBoneIndex = mModelData.DriverSeatBoneIndex;
 
     if (driverSeatBoneIndex == -1)
         return ESeatPosition::Center;
@@ -65,23 +121,20 @@ ESeatPosition CVehicleMetaData::getSeatPosition() const {
     return ESeatPosition::Center;
 }
 
-Vector3 CVehicleMetaData::calculateAcceleration() {
-    auto velocity = ENTITY::GET_ENTITY_SPEED_VECTOR(mVehicle, true);
-    return (velocity - mVelocity) / MISC::GET_FRAME_TIME();
+Vector3 CVehicleMetaData::calculateAcceleration(const SVehicleSnapshot& snapshot, float frameTime) const {
+    return (snapshot.SpeedVector - mVelocity) / frameTime;
 }
 
-Vector3 CVehicleMetaData::calculateAccelerationCentripetal() {
-    Vector3 worldVelocity = ENTITY::GET_ENTITY_VELOCITY(mVehicle);
-    Vector3 worldVelDelta = (worldVelocity - mWorldVelocity);
+Vector3 CVehicleMetaData::calculateAccelerationCentripetal(const SVehicleSnapshot& snapshot, float frameTime) const {
+    Vector3 worldVelDelta = (snapshot.WorldVelocity - mWorldVelocity);
 
-    Vector3 fwdVec = ENTITY::GET_ENTITY_FORWARD_VECTOR(mVehicle);
-    Vector3 upVec = ENTITY::GET_OFFSET_FROM_ENTITY_IN_WORLD_COORDS(mVehicle, { 0.0f, 0.0f, 1.0f })
-        - ENTITY::GET_ENTITY_COORDS(mVehicle, true);
+    Vector3 fwdVec = snapshot.ForwardVector;
+    Vector3 upVec = snapshot.UpVector;
     Vector3 rightVec = Cross(fwdVec, upVec);
 
     return Vector3 {
         -Dot(worldVelDelta, rightVec),
         Dot(worldVelDelta, fwdVec),
         Dot(worldVelDelta, upVec),
-    } / MISC::GET_FRAME_TIME();
+    } / frameTime;
 }
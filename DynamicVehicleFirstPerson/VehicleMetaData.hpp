@@ -1,31 +1,57 @@
 #pragma once
-#include <inc/types.h>
+#include "VehicleSnapshot.hpp"
+#include "Solver/SolverTypes.hpp"
 
-enum class ESeatPosition {
-    Left,
-    Center,
-    Right
+#include <inc/types.h>
+#include <cstdint>
+
+// Everything here only depends on the vehicle model, so it's looked up
+// once per model and re-used for every vehicle of that model.
+struct SModelData {
+    // Bike, quad or bicycle: uses different seat bones
+    bool IsBike = false;
+    bool IsPlane = false;
+    bool IsHeli = false;
+
+    // seat_dside_f, used to find the seat position
+    int DriverSeatBoneIndex = -1;
+    // seat_f for bikes, seat_dside_f otherwise
+    int CameraSeatBoneIndex = -1;
+
+    uintptr_t ModelInfo = 0;
+
+    // FPV camera offset from seat, from the model info
+    Vector3 CamSeatOffset{};
+    // Extra height for the camera when the rollcage (frame mod) is installed
+    float RollbarOffset = 0.0f;
 };
 
 class CVehicleMetaData {
 public:
     CVehicleMetaData(Vehicle vehicle);
 
-    void Update();
+    // frameTime: seconds since the previous Update
+    void Update(const SVehicleSnapshot& snapshot, float frameTime);
+    // Only keeps the velocities, for frames where the acceleration isn't used.
+    // Needs SpeedVector and WorldVelocity of the snapshot.
+    void UpdateVelocity(const SVehicleSnapshot& snapshot);
 
+    Vehicle GetVehicle() { return mVehicle; }
     Hash Model() { return mModel; }
+    const SModelData& ModelData() { return mModelData; }
     ESeatPosition GetSeatPosition() { return mSeatPosition; }
     Vector3 Acceleration() { return mAcceleration; }
     Vector3 AccelerationCentripetal() { return mAccelerationCentripetal; }
     bool IsDriverWindowPresent();
 private:
     ESeatPosition getSeatPosition() const;
-    Vector3 calculateAcceleration();
-    Vector3 calculateAccelerationCentripetal();
+    Vector3 calculateAcceleration(const SVehicleSnapshot& snapshot, float frameTime) const;
+    Vector3 calculateAccelerationCentripetal(const SVehicleSnapshot& snapshot, float frameTime) const;
 
     Vehicle mVehicle;
 
     Hash mModel = 0;
+    SModelData mModelData;
     ESeatPosition mSeatPosition = ESeatPosition::Center;
 
     Vector3 mVelocity{};
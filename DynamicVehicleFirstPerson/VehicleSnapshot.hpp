@@ -0,0 +1,39 @@
+#pragma once
+#include "Memory/VehicleExtensions.hpp"
+
+#include <inc/types.h>
+
+// Dynamic vehicle state, fetched once at the start of each tick.
+// Everything downstream reads from this instead of calling natives again,
+// so the camera math itself only depends on these values.
+struct SVehicleSnapshot {
+    Hash Model = 0;
+
+    // Degrees, rotation order 0
+    Vector3 Rotation{};
+    Vector3 RotationVelocity{};
+
+    // Relative to the vehicle
+    Vector3 SpeedVector{};
+
+    // World space
+    Vector3 WorldVelocity{};
+    Vector3 ForwardVector{};
+    Vector3 UpVector{};
+
+    // Degrees
+    float Pitch = 0.0f;
+    float Roll = 0.0f;
+
+    float Speed = 0.0f;
+    float EstimatedMaxSpeed = 0.0f;
+
+    float RPM = 0.0f;
+    float HoverTransformRatio = 0.0f;
+    // 0.0f: Forward, 1.0f: Vertical
+    float FlightNozzlePosition = 0.0f;
+
+    bool OnAllWheels = false;
+
+    VExt::SWheelData Wheels;
+};
@@ -0,0 +1,230 @@
+// Replays a camera trace recorded in-game through CCameraSolver.
+// Writes the resulting camera poses and reports the time spent per frame,
+// so tuning changes can be profiled and regression tested without the game.
+
+#include <Solver/CameraSolver.hpp>
+#include <Solver/CameraTrace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        std::string TraceFile;
+        std::string PosesFile;
+        std::string CompareFile;
+        float Tolerance = 1e-4f;
+        int Repeat = 1;
+    };
+
+    // Same order as the CSV columns
+    constexpr size_t poseValues = 12;
+
+    const char* poseHeader =
+        "frame,offset_x,offset_y,offset_z,rot_x,rot_y,rot_z,fov,minimap,"
+        "dof_near_out,dof_near_in,dof_far_in,dof_far_out";
+
+    std::array<float, poseValues> poseToArray(const SCameraSolverOutput& pose) {
+        return {
+            pose.Offset.x, pose.Offset.y, pose.Offset.z,
+            pose.Rotation.x, pose.Rotation.y, pose.Rotation.z,
+            pose.FOV, pose.MinimapAngle,
+            pose.DoFNearOutFocus, pose.DoFNearInFocus, pose.DoFFarInFocus, pose.DoFFarOutFocus,
+        };
+    }
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVReplay <trace> [options]\n"
+            "  --poses <file>      Write the camera pose of every frame as CSV\n"
+            "  --compare <file>    Compare the poses against a CSV from --poses, exit 1 on mismatch\n"
+            "  --tolerance <x>     Max absolute difference for --compare (default 1e-4)\n"
+            "  --repeat <n>        Replay n times for more stable timings (default 1)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--poses" && hasValue) {
+                options.PosesFile = argv[++i];
+            }
+            else if (arg == "--compare" && hasValue) {
+                options.CompareFile = argv[++i];
+            }
+            else if (arg == "--tolerance" && hasValue) {
+                options.Tolerance = std::stof(argv[++i]);
+            }
+            else if (arg == "--repeat" && hasValue) {
+                options.Repeat = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (!arg.starts_with("--") && options.TraceFile.empty()) {
+                options.TraceFile = arg;
+            }
+            else {
+                return false;
+            }
+        }
+        return !options.TraceFile.empty();
+    }
+
+    // Runs the whole trace once. Poses are only collected when asked,
+    // so timing runs only measure the solver and the trace decoding.
+    bool replay(CCameraTraceReader& reader, std::vector<SCameraSolverOutput>* poses, uint64_t& frames) {
+        CCameraSolver solver;
+        SCameraSolverInput input;
+        frames = 0;
+
+        reader.Rewind();
+        while (true) {
+            switch (reader.Next(input)) {
+                case ETraceRecord::Frame: {
+                    const SCameraSolverOutput pose = solver.Solve(input);
+                    if (poses) {
+                        poses->push_back(pose);
+                    }
+                    ++frames;
+                    break;
+                }
+                case ETraceRecord::Reset:
+                    solver.Reset();
+                    break;
+                case ETraceRecord::ResetShake:
+                    solver.ResetShake();
+                    break;
+                case ETraceRecord::End:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    bool writePoses(const std::string& posesFile, const std::vector<SCameraSolverOutput>& poses) {
+        std::ofstream file(posesFile);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << poseHeader << '\n';
+        for (size_t i = 0; i < poses.size(); ++i) {
+            file << i;
+            for (float value : poseToArray(poses[i])) {
+                char buffer[32];
+                std::snprintf(buffer, sizeof(buffer), ",%.9g", value);
+                file << buffer;
+            }
+            file << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Returns the number of mismatching frames, or -1 if the baseline can't be read.
+    int64_t comparePoses(const std::string& compareFile, const std::vector<SCameraSolverOutput>& poses, float tolerance) {
+        std::ifstream file(compareFile);
+        std::string line;
+        if (!file.is_open() || !std::getline(file, line)) {
+            return -1;
+        }
+
+        int64_t mismatches = 0;
+        size_t frame = 0;
+        for (; std::getline(file, line); ++frame) {
+            if (frame >= poses.size()) {
+                std::cerr << "Baseline has more frames than the replay (" << poses.size() << ")\n";
+                return mismatches + 1;
+            }
+
+            std::istringstream columns(line);
+            std::string column;
+            std::getline(columns, column, ',');
+
+            const auto actual = poseToArray(poses[frame]);
+            for (size_t i = 0; i < poseValues; ++i) {
+                float expected = 0.0f;
+                if (!std::getline(columns, column, ',')) {
+                    return -1;
+                }
+                expected = std::stof(column);
+                if (std::abs(actual[i] - expected) > tolerance) {
+                    if (mismatches < 10) {
+                        std::cerr << "Frame " << frame << ", column " << i + 1 <<
+                            ": expected " << expected << ", got " << actual[i] << '\n';
+                    }
+                    ++mismatches;
+                    break;
+                }
+            }
+        }
+
+        if (frame != poses.size()) {
+            std::cerr << "Baseline has " << frame << " frames, replay has " << poses.size() << '\n';
+            ++mismatches;
+        }
+        return mismatches;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    CCameraTraceReader reader;
+    if (!reader.Open(options.TraceFile)) {
+        std::cerr << reader.Error() << '\n';
+        return 2;
+    }
+
+    std::vector<SCameraSolverOutput> poses;
+    uint64_t frames = 0;
+    if (!replay(reader, &poses, frames)) {
+        std::cerr << "Replay failed after " << frames << " frames: " << reader.Error() << '\n';
+        return 2;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    for (int i = 0; i < options.Repeat; ++i) {
+        replay(reader, nullptr, frames);
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    const double totalFrames = static_cast<double>(frames) * options.Repeat;
+
+    std::fprintf(stderr, "%llu frames, %d runs, %.1f ns/frame\n",
+        static_cast<unsigned long long>(frames), options.Repeat, totalFrames > 0.0 ? elapsed / totalFrames : 0.0);
+
+    if (!options.PosesFile.empty() && !writePoses(options.PosesFile, poses)) {
+        std::cerr << "Failed to write " << options.PosesFile << '\n';
+        return 2;
+    }
+
+    if (!options.CompareFile.empty()) {
+        int64_t mismatches = comparePoses(options.CompareFile, poses, options.Tolerance);
+        if (mismatches < 0) {
+            std::cerr << "Failed to read " << options.CompareFile << '\n';
+            return 2;
+        }
+        if (mismatches > 0) {
+            std::cerr << mismatches << " frames differ from " << options.CompareFile << '\n';
+            return 1;
+        }
+        std::cerr << "Poses match " << options.CompareFile << '\n';
+    }
+    return 0;
+}
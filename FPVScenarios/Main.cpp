@@ -0,0 +1,251 @@
+// Runs CCameraSolver through synthetic drives (launch, braking, slalom, rough
+// roads, jumps, hovering, leaning) and reports the time per frame and how
+// smooth the camera moves in each. --trace-dir writes the drives as camera
+// traces, so FPVReplay can keep pose baselines of them.
+
+#include <Solver/CameraSolver.hpp>
+#include <Solver/CameraTrace.hpp>
+#include <Solver/DriveScenario.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        std::vector<EDriveScenario> Scenarios;
+        float FrameRate = 60.0f;
+        // 0: each scenario's default
+        float Duration = 0.0f;
+        int Repeat = 20;
+        std::string TraceDir;
+    };
+
+    // How the camera moves relative to the vehicle, i.e. what inertia,
+    // lean and shake add on top of the vehicle's own motion.
+    struct SSmoothness {
+        // Meters, from the mount offset
+        float PeakOffset = 0.0f;
+        // Degrees
+        float PeakRotation = 0.0f;
+        // Degrees per second squared, lower is smoother
+        float RotationAccelRms = 0.0f;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVScenarios [scenario...] [options]\n"
+            "  Scenarios:";
+        for (size_t i = 0; i < static_cast<size_t>(EDriveScenario::Count); ++i) {
+            std::cerr << ' ' << CDriveScenario::Name(static_cast<EDriveScenario>(i));
+        }
+        std::cerr << "\n"
+            "  Runs all scenarios when none are given.\n"
+            "  --fps <n>           Frame rate (default 60)\n"
+            "  --seconds <s>       Duration of each scenario (default: per scenario)\n"
+            "  --repeat <n>        Solve each scenario n times for the timing (default 20)\n"
+            "  --trace-dir <dir>   Also write each scenario as <dir>/<scenario>.fpvtrace\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            EDriveScenario scenario{};
+            if (arg == "--fps" && hasValue) {
+                options.FrameRate = std::max(1.0f, std::stof(argv[++i]));
+            }
+            else if (arg == "--seconds" && hasValue) {
+                options.Duration = std::max(0.0f, std::stof(argv[++i]));
+            }
+            else if (arg == "--repeat" && hasValue) {
+                options.Repeat = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--trace-dir" && hasValue) {
+                options.TraceDir = argv[++i];
+            }
+            else if (CDriveScenario::FromName(arg, scenario)) {
+                options.Scenarios.push_back(scenario);
+            }
+            else {
+                return false;
+            }
+        }
+
+        if (options.Scenarios.empty()) {
+            for (size_t i = 0; i < static_cast<size_t>(EDriveScenario::Count); ++i) {
+                options.Scenarios.push_back(static_cast<EDriveScenario>(i));
+            }
+        }
+        return true;
+    }
+
+    // The reactions from the shipped shake.ini for the materials the scenarios drive on.
+    CShakeData makeShakeData() {
+        CShakeData shakeData;
+        shakeData.SetMaterialReactions({
+            { eMaterial::CONCRETE_POTHOLE, { 4.00f, 0.50f } },
+            { eMaterial::TARMAC_POTHOLE, { 4.00f, 0.50f } },
+            { eMaterial::RUMBLE_STRIP, { 0.65f, 7.50f } },
+        });
+        return shakeData;
+    }
+
+    float wrapAngle(float degrees) {
+        return std::fmod(degrees + 540.0f, 360.0f) - 180.0f;
+    }
+
+    SSmoothness measure(const std::vector<SCameraSolverInput>& inputs,
+        const std::vector<SCameraSolverOutput>& poses) {
+        SSmoothness result;
+        if (inputs.empty()) {
+            return result;
+        }
+
+        const auto& mount = *inputs.front().Camera;
+        const SVector3 mountOffset{ mount.OffsetSide, mount.OffsetForward, mount.OffsetHeight };
+
+        double accelSquares = 0.0;
+        size_t accelSamples = 0;
+        SVector3 prevRotation{};
+        SVector3 prevRate{};
+        for (size_t i = 0; i < poses.size(); ++i) {
+            const SCameraSolverOutput& pose = poses[i];
+            const SVector3& vehicle = inputs[i].Rotation;
+            const SVector3 rotation{
+                wrapAngle(pose.Rotation.x - vehicle.x),
+                wrapAngle(pose.Rotation.y - vehicle.y),
+                wrapAngle(pose.Rotation.z - vehicle.z),
+            };
+
+            const SVector3 offset{
+                pose.Offset.x - mountOffset.x,
+                pose.Offset.y - mountOffset.y,
+                pose.Offset.z - mountOffset.z,
+            };
+            result.PeakOffset = std::max(result.PeakOffset,
+                std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z));
+            result.PeakRotation = std::max({ result.PeakRotation,
+                std::abs(rotation.x), std::abs(rotation.y), std::abs(rotation.z) });
+
+            const float dt = inputs[i].FrameTime;
+            const SVector3 rate{
+                wrapAngle(rotation.x - prevRotation.x) / dt,
+                wrapAngle(rotation.y - prevRotation.y) / dt,
+                wrapAngle(rotation.z - prevRotation.z) / dt,
+            };
+            if (i >= 2) {
+                const SVector3 accel{
+                    (rate.x - prevRate.x) / dt,
+                    (rate.y - prevRate.y) / dt,
+                    (rate.z - prevRate.z) / dt,
+                };
+                accelSquares += accel.x * accel.x + accel.y * accel.y + accel.z * accel.z;
+                ++accelSamples;
+            }
+            prevRotation = rotation;
+            prevRate = rate;
+        }
+
+        if (accelSamples > 0) {
+            result.RotationAccelRms = static_cast<float>(std::sqrt(accelSquares / static_cast<double>(accelSamples)));
+        }
+        return result;
+    }
+
+    bool writeTrace(const std::filesystem::path& traceFile, const std::vector<SCameraSolverInput>& inputs) {
+        CCameraTraceWriter writer;
+        if (!writer.Open(traceFile) || !writer.WriteReset() || !writer.WriteResetShake()) {
+            return false;
+        }
+        for (const auto& input : inputs) {
+            if (!writer.WriteFrame(input)) {
+                return false;
+            }
+        }
+        writer.Close();
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    CConfig::SCameraSettings camera;
+    camera.Name = "Default";
+    const CConfig::SLook look;
+    const CShakeData shakeData = makeShakeData();
+
+    if (!options.TraceDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(options.TraceDir, ec);
+    }
+
+    std::printf("%-16s %8s %10s %10s %10s %14s\n",
+        "Scenario", "Frames", "ns/frame", "Offset cm", "Rot deg", "Rot acc deg/s2");
+
+    using clock = std::chrono::steady_clock;
+    for (EDriveScenario scenario : options.Scenarios) {
+        // Generated up front, so the timing only covers the solver.
+        CDriveScenario drive(scenario, options.FrameRate, options.Duration);
+        std::vector<SCameraSolverInput> inputs;
+        inputs.reserve(drive.FrameCount());
+
+        SCameraSolverInput input;
+        input.Camera = &camera;
+        input.Look = &look;
+        input.ShakeData = &shakeData;
+        while (drive.Next(input)) {
+            inputs.push_back(input);
+        }
+
+        std::vector<SCameraSolverOutput> poses;
+        poses.reserve(inputs.size());
+        {
+            CCameraSolver solver;
+            for (const auto& frame : inputs) {
+                poses.push_back(solver.Solve(frame));
+            }
+        }
+
+        const auto start = clock::now();
+        for (int i = 0; i < options.Repeat; ++i) {
+            CCameraSolver solver;
+            for (const auto& frame : inputs) {
+                solver.Solve(frame);
+            }
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        const double frames = static_cast<double>(inputs.size()) * options.Repeat;
+
+        const SSmoothness smoothness = measure(inputs, poses);
+        std::printf("%-16s %8zu %10.1f %10.2f %10.2f %14.1f\n",
+            CDriveScenario::Name(scenario), inputs.size(), frames > 0.0 ? elapsed / frames : 0.0,
+            smoothness.PeakOffset * 100.0f, smoothness.PeakRotation, smoothness.RotationAccelRms);
+
+        if (!options.TraceDir.empty()) {
+            const auto traceFile = std::filesystem::path(options.TraceDir) /
+                (std::string(CDriveScenario::Name(scenario)) + ".fpvtrace");
+            if (!writeTrace(traceFile, inputs)) {
+                std::cerr << "Failed to write " << traceFile.string() << '\n';
+                return 2;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,300 @@
+// Runs CFPVScript::Tick() against the native stand-in, outside the game.
+// Drives a vehicle along a fixed route and reports the time per tick and
+// which natives the script calls, so the native-call overhead can be
+// profiled and compared between changes.
+// With several --fps values, the same route is driven at each frame rate,
+// to check the camera ends up in the same place regardless.
+
+#include "NativeStandin.hpp"
+
+#include <Config.hpp>
+#include <ConfigIndex.hpp>
+#include <FPVScript.hpp>
+#include <ScriptSettings.hpp>
+#include <ShakeData.hpp>
+#include <Util/FrameClock.hpp>
+#include <Util/Logger.hpp>
+#include <Util/Profiler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct SOptions {
+        float Seconds = 120.0f;
+        int Warmup = 300;
+        std::vector<float> FrameRates;
+        std::string ConfigFile;
+        std::string ShakeFile;
+        bool Stages = false;
+    };
+
+    struct SRunResult {
+        float FrameRate = 0.0f;
+        int Ticks = 0;
+        double Avg = 0.0;
+        double P50 = 0.0;
+        double P99 = 0.0;
+        double NativesPerTick = 0.0;
+        // Camera relative to the vehicle at the end of the route
+        Vector3 Rotation{};
+        Vector3 Offset{};
+        bool Rendering = false;
+    };
+
+    void printUsage() {
+        std::cerr <<
+            "Usage: FPVNativeBench [options]\n"
+            "  --seconds <s>       Length of the route (default 120)\n"
+            "  --warmup <n>        Ticks to run before timing (default 300)\n"
+            "  --fps <list>        Frame rates to drive at, comma separated (default 60)\n"
+            "  --config <file>     Vehicle config to use instead of the default camera\n"
+            "  --shake <file>      Shake data, like ShakeData.ini\n"
+            "  --stages            Also report the profiler stages, over the last "
+            << CProfiler::WindowSize << " ticks\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], SOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--seconds" && hasValue) {
+                options.Seconds = std::max(1.0f, std::stof(argv[++i]));
+            }
+            else if (arg == "--warmup" && hasValue) {
+                options.Warmup = std::max(0, std::stoi(argv[++i]));
+            }
+            else if (arg == "--fps" && hasValue) {
+                std::stringstream list(argv[++i]);
+                std::string value;
+                while (std::getline(list, value, ',')) {
+                    options.FrameRates.push_back(std::max(1.0f, std::stof(value)));
+                }
+            }
+            else if (arg == "--config" && hasValue) {
+                options.ConfigFile = argv[++i];
+            }
+            else if (arg == "--shake" && hasValue) {
+                options.ShakeFile = argv[++i];
+            }
+            else if (arg == "--stages") {
+                options.Stages = true;
+            }
+            else {
+                return false;
+            }
+        }
+        if (options.FrameRates.empty()) {
+            options.FrameRates.push_back(60.0f);
+        }
+        return true;
+    }
+
+    // Accelerates to about 100 km/h, weaves left and right and runs over
+    // a bump every few seconds. Only depends on the time, not the frame rate.
+    void drive(float t) {
+        auto& vehicle = Standin::World().Vehicle;
+
+        const float speed = std::min(28.0f, 4.0f * t);
+        const float yaw = vehicle.Rotation.z * 3.14159265f / 180.0f;
+        vehicle.Velocity = { -std::sin(yaw) * speed, std::cos(yaw) * speed, 0.0f };
+        vehicle.RotationVelocity = { 0.0f, 0.05f * std::sin(1.3f * t), 0.4f * std::sin(0.5f * t) };
+        vehicle.RPM = 0.2f + 0.8f * speed / 28.0f;
+
+        const float bump = std::fmod(t, 4.0f) < 0.15f ? 0.3f : 0.0f;
+        for (size_t i = 0; i < vehicle.Wheels.size(); ++i) {
+            vehicle.Wheels[i].Compression = 0.1f + 0.02f * std::sin(7.0f * t + static_cast<float>(i)) +
+                (i < 2 ? bump : 0.0f);
+        }
+    }
+
+    double percentile(std::vector<double> values, double fraction) {
+        const size_t index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    SRunResult run(const SOptions& options, float frameRate,
+        const std::shared_ptr<CScriptSettings>& settings,
+        const std::shared_ptr<CShakeData>& shakeData,
+        std::list<CConfig>& configs,
+        const CConfigIndex& configIndex,
+        CProfiler& profiler) {
+        auto& world = Standin::World();
+        const auto modPath = world.ModPath;
+        world = Standin::SWorldState{};
+        world.ModPath = modPath;
+        world.FrameTime = 1.0f / frameRate;
+        Standin::ResetNativeCounts();
+
+        CFixedFrameClock frameClock(world.FrameTime, world.TimeScale);
+        CFPVScript script(settings, shakeData, configs, configIndex, profiler, frameClock);
+        profiler.SetEnabled(options.Stages);
+
+        SRunResult result;
+        result.FrameRate = frameRate;
+        result.Ticks = std::max(1, static_cast<int>(std::lround(options.Seconds * frameRate)) - options.Warmup);
+
+        using clock = std::chrono::steady_clock;
+        std::vector<double> tickTimes;
+        tickTimes.reserve(result.Ticks);
+
+        const int totalTicks = options.Warmup + result.Ticks;
+        for (int tick = 0; tick < totalTicks; ++tick) {
+            if (tick == options.Warmup) {
+                Standin::ResetNativeCounts();
+            }
+
+            drive(static_cast<float>(tick) * world.FrameTime);
+            Standin::Advance();
+            profiler.BeginFrame();
+            frameClock.Tick();
+
+            const auto start = clock::now();
+            {
+                CProfiler::CScope scope(&profiler, EProfileStage::ScriptTick);
+                script.Tick();
+            }
+            const auto end = clock::now();
+
+            if (tick >= options.Warmup) {
+                tickTimes.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            }
+        }
+
+        double total = 0.0;
+        for (double time : tickTimes) {
+            total += time;
+        }
+
+        const double ticks = static_cast<double>(result.Ticks);
+        result.Avg = total / ticks;
+        result.P50 = percentile(tickTimes, 0.5);
+        result.P99 = percentile(tickTimes, 0.99);
+        result.NativesPerTick = static_cast<double>(Standin::NativeCallTotal()) / ticks;
+
+        const auto& camera = world.Camera;
+        result.Rendering = camera.Rendering;
+        result.Rotation = {
+            camera.Rotation.x - world.Vehicle.Rotation.x,
+            camera.Rotation.y - world.Vehicle.Rotation.y,
+            std::fmod(camera.Rotation.z - world.Vehicle.Rotation.z + 540.0f, 360.0f) - 180.0f,
+        };
+        result.Offset = camera.AttachOffset;
+        return result;
+    }
+
+    void printNatives(double ticks) {
+        std::printf("\n%-52s %10s\n", "Native", "Per tick");
+        for (const auto& native : Standin::NativeCounts()) {
+            char unknown[64];
+            if (!native.Name) {
+                std::snprintf(unknown, sizeof(unknown), "0x%016llX (stand-in missing)",
+                    static_cast<unsigned long long>(native.Hash));
+            }
+            std::printf("%-52s %10.2f\n", native.Name ? native.Name : unknown,
+                static_cast<double>(native.Calls) / ticks);
+        }
+    }
+
+    void printStages(const CProfiler& profiler) {
+        std::printf("\n%-12s %10s %10s %10s %10s\n", "Stage (us)", "min", "avg", "p99", "max");
+        for (size_t i = 0; i < CProfiler::StageCount; ++i) {
+            const auto stage = static_cast<EProfileStage>(i);
+            const CProfiler::SStats stats = profiler.Stats(stage);
+            if (stats.Samples == 0) {
+                continue;
+            }
+            std::printf("%-12s %10.2f %10.2f %10.2f %10.2f\n",
+                CProfiler::StageName(stage), stats.Min, stats.Avg, stats.P99, stats.Max);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    }
+    catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    const auto modPath = Standin::World().ModPath;
+    std::filesystem::create_directories(modPath);
+    g_Logger.SetFile((modPath / "FPVNativeBench.log").string());
+    g_Logger.SetMinLevel(WARN);
+    g_Logger.Clear();
+
+    // Defaults only, so a local settings file doesn't change the numbers.
+    auto settings = std::make_shared<CScriptSettings>((modPath / "settings_general.ini").string());
+    auto shakeData = options.ShakeFile.empty() ?
+        std::make_shared<CShakeData>() :
+        std::make_shared<CShakeData>(options.ShakeFile);
+
+    std::list<CConfig> configs;
+    if (options.ConfigFile.empty()) {
+        CConfig& config = configs.emplace_back();
+        config.Name = "Default";
+        config.Mount.emplace_back().Name = "Default";
+    }
+    else {
+        configs.push_back(CConfig::Read(options.ConfigFile));
+        if (configs.back().Mount.empty()) {
+            std::cerr << "No cameras in " << options.ConfigFile << '\n';
+            return 2;
+        }
+    }
+
+    CConfigIndex configIndex;
+    configIndex.Build(configs);
+
+    CProfiler profiler;
+
+    std::vector<SRunResult> results;
+    for (float frameRate : options.FrameRates) {
+        results.push_back(run(options, frameRate, settings, shakeData, configs, configIndex, profiler));
+    }
+
+    if (results.size() == 1) {
+        const SRunResult& result = results.front();
+        std::printf("%d ticks: avg %.0f ns, p50 %.0f ns, p99 %.0f ns per tick\n",
+            result.Ticks, result.Avg, result.P50, result.P99);
+        std::printf("%.1f natives per tick\n", result.NativesPerTick);
+        printNatives(static_cast<double>(result.Ticks));
+    }
+    else {
+        std::printf("%6s %8s %9s %9s %8s   %-26s   %s\n",
+            "FPS", "Ticks", "Avg ns", "P99 ns", "Natives", "Rotation (pitch roll yaw)", "Offset");
+        for (const SRunResult& result : results) {
+            std::printf("%6.1f %8d %9.0f %9.0f %8.1f   %8.3f %8.3f %8.3f   %6.3f %6.3f %6.3f\n",
+                result.FrameRate, result.Ticks, result.Avg, result.P99, result.NativesPerTick,
+                result.Rotation.x, result.Rotation.y, result.Rotation.z,
+                result.Offset.x, result.Offset.y, result.Offset.z);
+        }
+    }
+
+    if (options.Stages) {
+        printStages(profiler);
+    }
+
+    for (const SRunResult& result : results) {
+        if (!result.Rendering) {
+            std::cerr << "The camera isn't rendering at " << result.FrameRate << " fps\n";
+            return 1;
+        }
+    }
+    return 0;
+}
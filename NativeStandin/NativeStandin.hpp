@@ -0,0 +1,120 @@
+#pragma once
+#include <inc/types.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Stand-in for the ScriptHookV native layer and the game memory the script reads,
+// so the script runs outside the game. Natives read from and write to this state.
+// Only natives the script uses are implemented, the rest return 0 and are counted.
+namespace Standin {
+    enum class EVehicleClass {
+        Car,
+        Bike,
+        Quadbike,
+        Bicycle,
+        Plane,
+        Heli,
+    };
+
+    struct SWheelState {
+        float Compression = 0.1f;
+        uint16_t Material = 4; // eMaterial::CONCRETE
+    };
+
+    struct SVehicleState {
+        Vehicle Handle = 2;
+        Hash Model = 0xB779A091; // adder
+        std::string DisplayName = "ADDER";
+        std::string Plate = "STANDIN ";
+        EVehicleClass Class = EVehicleClass::Car;
+
+        // World, meters
+        Vector3 Position{};
+        // Degrees: pitch, roll, yaw
+        Vector3 Rotation{};
+        // Radians per second, relative to the vehicle
+        Vector3 RotationVelocity{};
+        // World, m/s
+        Vector3 Velocity{};
+
+        float EstimatedMaxSpeed = 60.0f;
+        float RPM = 0.2f;
+        float HoverTransformRatio = 0.0f;
+        float FlightNozzlePosition = 0.0f;
+        bool OnAllWheels = true;
+        bool WindowsIntact = true;
+        // Frame mod installed
+        bool RollCage = false;
+        std::vector<SWheelState> Wheels = std::vector<SWheelState>(4);
+
+        Vector3 DimensionsMin{ -1.0f, -2.3f, -0.6f };
+        Vector3 DimensionsMax{ 1.0f, 2.3f, 0.7f };
+        // Relative to the vehicle, for seat_dside_f and seat_f
+        Vector3 DriverSeatOffset{ -0.4f, -0.2f, 0.3f };
+        // From the model info
+        Vector3 CamSeatOffset{ 0.0f, 0.0f, 0.6f };
+        float RollbarOffset = 0.05f;
+    };
+
+    struct SCameraState {
+        Cam Handle = -1;
+        bool Active = false;
+        bool Rendering = false;
+        Entity AttachedTo = 0;
+        Vector3 AttachOffset{};
+        Vector3 Rotation{};
+        float FOV = 0.0f;
+        float NearClip = 0.0f;
+        float FarClip = 0.0f;
+        int MinimapAngle = -1;
+    };
+
+    struct SWorldState {
+        int GameVersion = 80;
+        float FrameTime = 1.0f / 60.0f;
+        float TimeScale = 1.0f;
+
+        Player PlayerId = 0;
+        Ped PlayerPed = 1;
+        bool InVehicle = true;
+        bool PlayerControl = true;
+        // GET_FOLLOW_VEHICLE_CAM_VIEW_MODE, 4 is first person
+        int ViewMode = 4;
+
+        bool KeyboardAndMouse = false;
+        // By control action
+        std::unordered_map<int, float> ControlNormals;
+        std::unordered_set<int> PressedControls;
+
+        SVehicleState Vehicle;
+        // Written by the CAM natives
+        SCameraState Camera;
+
+        std::filesystem::path ModPath = std::filesystem::temp_directory_path() / "DynamicVehicleFirstPerson";
+    };
+
+    SWorldState& World();
+
+    // Moves the vehicle by its velocity and rotation velocity for one frame.
+    void Advance();
+
+    // Relative to the vehicle, like GET_ENTITY_SPEED_VECTOR(vehicle, true).
+    Vector3 SpeedVector(const SVehicleState& vehicle);
+
+    struct SNativeCount {
+        uint64_t Hash = 0;
+        // nullptr for natives the stand-in doesn't implement
+        const char* Name = nullptr;
+        uint64_t Calls = 0;
+    };
+
+    // Most called first.
+    std::vector<SNativeCount> NativeCounts();
+    uint64_t NativeCallTotal();
+    void ResetNativeCounts();
+}
@@ -0,0 +1,400 @@
+#include "NativeStandin.hpp"
+
+#include <inc/main.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace {
+    Standin::SWorldState world;
+
+    struct SCall {
+        std::array<UINT64, 32> Args{};
+        size_t ArgCount = 0;
+
+        template <typename T>
+        T Arg(size_t index) const {
+            T value{};
+            std::memcpy(&value, &Args[index], sizeof(T));
+            return value;
+        }
+
+        // The SDK pushes vectors as three floats.
+        Vector3 ArgVector3(size_t index) const {
+            return { Arg<float>(index), Arg<float>(index + 1), Arg<float>(index + 2) };
+        }
+    };
+
+    using NativeHandler = void(*)(const SCall& call);
+
+    struct SNative {
+        const char* Name = nullptr;
+        NativeHandler Handler = nullptr;
+        uint64_t Calls = 0;
+    };
+
+    SCall currentCall;
+    SNative* currentNative = nullptr;
+
+    // invoke<R> reads R from here. Scalars are in the first slot,
+    // a Vector3 is read as three 8-byte aligned floats.
+    std::array<UINT64, 4> result{};
+
+    template <typename T>
+    void setResult(T value) {
+        static_assert(sizeof(T) <= sizeof(UINT64));
+        std::memcpy(result.data(), &value, sizeof(T));
+    }
+
+    void setResult(const Vector3& value) {
+        static_assert(sizeof(Vector3) <= sizeof(result));
+        std::memcpy(result.data(), &value, sizeof(Vector3));
+    }
+
+    constexpr float deg2rad(float degrees) {
+        return degrees * std::numbers::pi_v<float> / 180.0f;
+    }
+
+    Vector3 add(const Vector3& a, const Vector3& b) {
+        return { a.x + b.x, a.y + b.y, a.z + b.z };
+    }
+
+    Vector3 sub(const Vector3& a, const Vector3& b) {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    Vector3 rotateX(const Vector3& v, float angle) {
+        float c = std::cos(angle), s = std::sin(angle);
+        return { v.x, c * v.y - s * v.z, s * v.y + c * v.z };
+    }
+
+    Vector3 rotateY(const Vector3& v, float angle) {
+        float c = std::cos(angle), s = std::sin(angle);
+        return { c * v.x + s * v.z, v.y, -s * v.x + c * v.z };
+    }
+
+    Vector3 rotateZ(const Vector3& v, float angle) {
+        float c = std::cos(angle), s = std::sin(angle);
+        return { c * v.x - s * v.y, s * v.x + c * v.y, v.z };
+    }
+
+    // Vehicle space to world space, yaw * pitch * roll.
+    Vector3 toWorldDirection(const Standin::SVehicleState& vehicle, const Vector3& v) {
+        const Vector3& rot = vehicle.Rotation;
+        return rotateZ(rotateX(rotateY(v, deg2rad(rot.y)), deg2rad(rot.x)), deg2rad(rot.z));
+    }
+
+    Vector3 toVehicleDirection(const Standin::SVehicleState& vehicle, const Vector3& v) {
+        const Vector3& rot = vehicle.Rotation;
+        return rotateY(rotateX(rotateZ(v, -deg2rad(rot.z)), -deg2rad(rot.x)), -deg2rad(rot.y));
+    }
+
+    Vector3 toWorld(const Standin::SVehicleState& vehicle, const Vector3& offset) {
+        return add(vehicle.Position, toWorldDirection(vehicle, offset));
+    }
+
+    Vector3 toVehicle(const Standin::SVehicleState& vehicle, const Vector3& position) {
+        return toVehicleDirection(vehicle, sub(position, vehicle.Position));
+    }
+
+    bool isVehicle(Entity entity) {
+        return world.InVehicle && entity == world.Vehicle.Handle;
+    }
+
+    bool isModel(Hash model, Standin::EVehicleClass vehicleClass) {
+        return model == world.Vehicle.Model && world.Vehicle.Class == vehicleClass;
+    }
+
+    // Seats and the player's bones are placed relative to the driver seat.
+    Vector3 pedBoneWorld(int boneId) {
+        Vector3 offset = world.Vehicle.DriverSeatOffset;
+        switch (boneId) {
+            case 0x796E: offset.z += 0.65f; break; // SKEL_Head
+            case 0xE0FD: offset.z += 0.10f; break; // SKEL_Spine_Root
+            default: break;
+        }
+        return toWorld(world.Vehicle, offset);
+    }
+
+    void noop(const SCall&) {}
+
+    std::unordered_map<uint64_t, SNative> buildNatives() {
+        std::unordered_map<uint64_t, SNative> natives;
+        auto define = [&](uint64_t hash, const char* name, NativeHandler handler) {
+            natives[hash] = { name, handler, 0 };
+        };
+
+        // PLAYER, PED
+        define(0x4F8644AF03D0E0D6, "PLAYER::PLAYER_ID", [](const SCall&) { setResult(world.PlayerId); });
+        define(0xD80958FC74E988A6, "PLAYER::PLAYER_PED_ID", [](const SCall&) { setResult(world.PlayerPed); });
+        define(0x49C32D60007AFA47, "PLAYER::IS_PLAYER_CONTROL_ON", [](const SCall&) { setResult<BOOL>(world.PlayerControl); });
+        define(0x388A47C51ABDAC8E, "PLAYER::IS_PLAYER_BEING_ARRESTED", [](const SCall&) { setResult<BOOL>(FALSE); });
+        define(0xD3C2E180A40F031E, "CUTSCENE::IS_CUTSCENE_PLAYING", [](const SCall&) { setResult<BOOL>(FALSE); });
+        define(0x9A9112A0FE9A4713, "PED::GET_VEHICLE_PED_IS_IN", [](const SCall&) {
+            setResult<Vehicle>(world.InVehicle ? world.Vehicle.Handle : 0);
+        });
+        define(0xA808AA1D79230FC2, "PED::IS_PED_SITTING_IN_VEHICLE", [](const SCall& call) {
+            setResult<BOOL>(call.Arg<Ped>(0) == world.PlayerPed && isVehicle(call.Arg<Vehicle>(1)));
+        });
+        define(0xBB40DD2270B65366, "VEHICLE::GET_PED_IN_VEHICLE_SEAT", [](const SCall& call) {
+            bool driver = isVehicle(call.Arg<Vehicle>(0)) && call.Arg<int>(1) == -1;
+            setResult<Ped>(driver ? world.PlayerPed : 0);
+        });
+        define(0x17C07FC640E86B4E, "PED::GET_PED_BONE_COORDS", [](const SCall& call) {
+            setResult(add(pedBoneWorld(call.Arg<int>(1)), call.ArgVector3(2)));
+        });
+        define(0x898CC20EA75BACD8, "PED::GET_PED_PROP_INDEX", [](const SCall&) { setResult(-1); });
+        define(0xE131A28626F81AB2, "PED::GET_PED_PROP_TEXTURE_INDEX", [](const SCall&) { setResult(-1); });
+        define(0x0943E5B8E078E76E, "PED::CLEAR_PED_PROP", noop);
+        define(0x93376B65A266EB5F, "PED::SET_PED_PROP_INDEX", noop);
+
+        // ENTITY
+        define(0x7239B21A38F536BA, "ENTITY::DOES_ENTITY_EXIST", [](const SCall& call) {
+            Entity entity = call.Arg<Entity>(0);
+            setResult<BOOL>(entity == world.PlayerPed || isVehicle(entity));
+        });
+        define(0x5F9532F3B5CC2551, "ENTITY::IS_ENTITY_DEAD", [](const SCall&) { setResult<BOOL>(FALSE); });
+        define(0x9F47B058362C84B5, "ENTITY::GET_ENTITY_MODEL", [](const SCall& call) {
+            setResult<Hash>(isVehicle(call.Arg<Entity>(0)) ? world.Vehicle.Model : 0);
+        });
+        define(0x3FEF770D40960D5A, "ENTITY::GET_ENTITY_COORDS", [](const SCall& call) {
+            setResult(call.Arg<Entity>(0) == world.PlayerPed ? pedBoneWorld(0) : world.Vehicle.Position);
+        });
+        define(0xAFBD61CC738D9EB9, "ENTITY::GET_ENTITY_ROTATION", [](const SCall&) { setResult(world.Vehicle.Rotation); });
+        define(0x213B91045D09B983, "ENTITY::GET_ENTITY_ROTATION_VELOCITY", [](const SCall&) {
+            setResult(world.Vehicle.RotationVelocity);
+        });
+        define(0x0A794A5A57F8DF91, "ENTITY::GET_ENTITY_FORWARD_VECTOR", [](const SCall&) {
+            setResult(toWorldDirection(world.Vehicle, { 0.0f, 1.0f, 0.0f }));
+        });
+        define(0xD45DC2893621E1FE, "ENTITY::GET_ENTITY_PITCH", [](const SCall&) { setResult(world.Vehicle.Rotation.x); });
+        define(0x831E0242595560DF, "ENTITY::GET_ENTITY_ROLL", [](const SCall&) { setResult(world.Vehicle.Rotation.y); });
+        define(0xD5037BA82E12416F, "ENTITY::GET_ENTITY_SPEED", [](const SCall&) {
+            const Vector3& v = world.Vehicle.Velocity;
+            setResult(std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z));
+        });
+        define(0x9A8D700A51CB7B0D, "ENTITY::GET_ENTITY_SPEED_VECTOR", [](const SCall& call) {
+            setResult(call.Arg<BOOL>(1) ? Standin::SpeedVector(world.Vehicle) : world.Vehicle.Velocity);
+        });
+        define(0x4805D2B1D8CF94A9, "ENTITY::GET_ENTITY_VELOCITY", [](const SCall&) { setResult(world.Vehicle.Velocity); });
+        define(0x1899F328B0E12848, "ENTITY::GET_OFFSET_FROM_ENTITY_IN_WORLD_COORDS", [](const SCall& call) {
+            setResult(toWorld(world.Vehicle, call.ArgVector3(1)));
+        });
+        define(0x2274BC1C4885E333, "ENTITY::GET_OFFSET_FROM_ENTITY_GIVEN_WORLD_COORDS", [](const SCall& call) {
+            setResult(toVehicle(world.Vehicle, call.ArgVector3(1)));
+        });
+        define(0xFB71170B7E76ACBA, "ENTITY::GET_ENTITY_BONE_INDEX_BY_NAME", [](const SCall& call) {
+            std::string_view bone = call.Arg<const char*>(1);
+            setResult(bone == "seat_dside_f" ? 1 : bone == "seat_f" ? 2 : -1);
+        });
+        define(0x44A8FCB8ED227738, "ENTITY::GET_WORLD_POSITION_OF_ENTITY_BONE", [](const SCall& call) {
+            int bone = call.Arg<int>(1);
+            setResult(bone > 0 ? toWorld(world.Vehicle, world.Vehicle.DriverSeatOffset) : world.Vehicle.Position);
+        });
+
+        // VEHICLE, MISC
+        define(0xB50C0B0CEDC6CE84, "VEHICLE::IS_THIS_MODEL_A_BIKE", [](const SCall& call) {
+            setResult<BOOL>(isModel(call.Arg<Hash>(0), Standin::EVehicleClass::Bike));
+        });
+        define(0x39DAC362EE65FA28, "VEHICLE::IS_THIS_MODEL_A_QUADBIKE", [](const SCall& call) {
+            setResult<BOOL>(isModel(call.Arg<Hash>(0), Standin::EVehicleClass::Quadbike));
+        });
+        define(0xBF94DD42F63BDED2, "VEHICLE::IS_THIS_MODEL_A_BICYCLE", [](const SCall& call) {
+            setResult<BOOL>(isModel(call.Arg<Hash>(0), Standin::EVehicleClass::Bicycle));
+        });
+        define(0xA0948AB42D7BA0DE, "VEHICLE::IS_THIS_MODEL_A_PLANE", [](const SCall& call) {
+            setResult<BOOL>(isModel(call.Arg<Hash>(0), Standin::EVehicleClass::Plane));
+        });
+        define(0xDCE4334788AF94EA, "VEHICLE::IS_THIS_MODEL_A_HELI", [](const SCall& call) {
+            setResult<BOOL>(isModel(call.Arg<Hash>(0), Standin::EVehicleClass::Heli));
+        });
+        define(0x53AF99BAA671CA47, "VEHICLE::GET_VEHICLE_ESTIMATED_MAX_SPEED", [](const SCall&) {
+            setResult(world.Vehicle.EstimatedMaxSpeed);
+        });
+        define(0xDA62027C8BDB326E, "VEHICLE::GET_VEHICLE_FLIGHT_NOZZLE_POSITION", [](const SCall&) {
+            setResult(world.Vehicle.FlightNozzlePosition);
+        });
+        define(0xB104CD1BABF302E2, "VEHICLE::IS_VEHICLE_ON_ALL_WHEELS", [](const SCall&) {
+            setResult<BOOL>(world.Vehicle.OnAllWheels);
+        });
+        define(0x46E571A0E20D01F1, "VEHICLE::IS_VEHICLE_WINDOW_INTACT", [](const SCall&) {
+            setResult<BOOL>(world.Vehicle.WindowsIntact);
+        });
+        define(0x772960298DA26FDB, "VEHICLE::GET_VEHICLE_MOD", [](const SCall& call) {
+            // VehicleModFrame
+            setResult(call.Arg<int>(1) == 5 && world.Vehicle.RollCage ? 0 : -1);
+        });
+        define(0x7CE1CCB9B293020E, "VEHICLE::GET_VEHICLE_NUMBER_PLATE_TEXT", [](const SCall&) {
+            setResult(world.Vehicle.Plate.c_str());
+        });
+        define(0xB215AAC32D25D019, "VEHICLE::GET_DISPLAY_NAME_FROM_VEHICLE_MODEL", [](const SCall&) {
+            setResult(world.Vehicle.DisplayName.c_str());
+        });
+        define(0x84FD40F56075E816, "VEHICLE::SET_CAR_HIGH_SPEED_BUMP_SEVERITY_MULTIPLIER", noop);
+        define(0x15C40837039FFAF7, "MISC::GET_FRAME_TIME", [](const SCall&) { setResult(world.FrameTime); });
+        define(0x03E8D3D5F549087A, "MISC::GET_MODEL_DIMENSIONS", [](const SCall& call) {
+            if (auto* min = call.Arg<Vector3*>(1)) *min = world.Vehicle.DimensionsMin;
+            if (auto* max = call.Arg<Vector3*>(2)) *max = world.Vehicle.DimensionsMax;
+        });
+
+        // PAD
+        define(0xEC3C9B8D5327B563, "PAD::GET_CONTROL_NORMAL", [](const SCall& call) {
+            auto it = world.ControlNormals.find(call.Arg<int>(1));
+            setResult(it == world.ControlNormals.end() ? 0.0f : it->second);
+        });
+        define(0xF3A21BCD95725A4A, "PAD::IS_CONTROL_PRESSED", [](const SCall& call) {
+            setResult<BOOL>(world.PressedControls.contains(call.Arg<int>(1)));
+        });
+        define(0xA571D46727E2B718, "PAD::IS_USING_KEYBOARD_AND_MOUSE", [](const SCall&) {
+            setResult<BOOL>(world.KeyboardAndMouse);
+        });
+        define(0xFE99B66D079CF6BC, "PAD::DISABLE_CONTROL_ACTION", noop);
+
+        // CAM
+        define(0xA4FF579AC0E3AAAE, "CAM::GET_FOLLOW_VEHICLE_CAM_VIEW_MODE", [](const SCall&) { setResult(world.ViewMode); });
+        define(0xB51194800B257161, "CAM::CREATE_CAM_WITH_PARAMS", [](const SCall& call) {
+            static Cam nextHandle = 100;
+            world.Camera = {};
+            world.Camera.Handle = nextHandle++;
+            world.Camera.FOV = call.Arg<float>(7);
+            setResult(world.Camera.Handle);
+        });
+        define(0xA7A932170592B50E, "CAM::DOES_CAM_EXIST", [](const SCall& call) {
+            setResult<BOOL>(call.Arg<Cam>(0) != -1 && call.Arg<Cam>(0) == world.Camera.Handle);
+        });
+        define(0x865908C81A2C22E9, "CAM::DESTROY_CAM", [](const SCall& call) {
+            if (call.Arg<Cam>(0) == world.Camera.Handle) {
+                world.Camera = {};
+            }
+        });
+        define(0x026FB97D0A425F84, "CAM::SET_CAM_ACTIVE", [](const SCall& call) {
+            world.Camera.Active = call.Arg<BOOL>(1);
+        });
+        define(0x07E5B515DB0636FC, "CAM::RENDER_SCRIPT_CAMS", [](const SCall& call) {
+            world.Camera.Rendering = call.Arg<BOOL>(0);
+        });
+        define(0xFEDB7D269E8C60E3, "CAM::ATTACH_CAM_TO_ENTITY", [](const SCall& call) {
+            world.Camera.AttachedTo = call.Arg<Entity>(1);
+            world.Camera.AttachOffset = call.ArgVector3(2);
+        });
+        define(0x61A3DBA14AB7F411, "CAM::ATTACH_CAM_TO_PED_BONE", [](const SCall& call) {
+            world.Camera.AttachedTo = call.Arg<Ped>(1);
+            world.Camera.AttachOffset = call.ArgVector3(3);
+        });
+        define(0x85973643155D0B07, "CAM::SET_CAM_ROT", [](const SCall& call) { world.Camera.Rotation = call.ArgVector3(1); });
+        define(0xB13C14F66A00D047, "CAM::SET_CAM_FOV", [](const SCall& call) { world.Camera.FOV = call.Arg<float>(1); });
+        define(0xC7848EFCCC545182, "CAM::SET_CAM_NEAR_CLIP", [](const SCall& call) { world.Camera.NearClip = call.Arg<float>(1); });
+        define(0xAE306F2A904BF86E, "CAM::SET_CAM_FAR_CLIP", [](const SCall& call) { world.Camera.FarClip = call.Arg<float>(1); });
+        define(0xA2767257A320FC82, "CAM::SET_CAM_IS_INSIDE_VEHICLE", noop);
+        define(0x469F2ECDEC046337, "CAM::SET_SCRIPTED_CAMERA_IS_FIRST_PERSON_THIS_FRAME", noop);
+        define(0x3CF48F6F96E749DC, "CAM::SET_CAM_DOF_PLANES", noop);
+        define(0x16A96863A17552BB, "CAM::SET_CAM_USE_SHALLOW_DOF_MODE", noop);
+        define(0xA13B0222F3D94A94, "CAM::SET_USE_HI_DOF", noop);
+        define(0xEEC4047028426510, "GRAPHICS::SET_PARTICLE_FX_CAM_INSIDE_VEHICLE", noop);
+
+        // HUD
+        define(0x299FAEBB108AE05B, "HUD::LOCK_MINIMAP_ANGLE", [](const SCall& call) {
+            world.Camera.MinimapAngle = call.Arg<int>(0);
+        });
+        define(0x8183455E16C42E3A, "HUD::UNLOCK_MINIMAP_ANGLE", [](const SCall&) { world.Camera.MinimapAngle = -1; });
+        define(0x7B5280EBA9840C72, "HUD::GET_FILENAME_FOR_AUDIO_CONVERSATION", [](const SCall&) { setResult("NULL"); });
+        define(0x2ED7843F8F801023, "HUD::END_TEXT_COMMAND_THEFEED_POST_TICKER", [](const SCall&) { setResult(1); });
+        define(0x6C188BE134E074AA, "HUD::ADD_TEXT_COMPONENT_SUBSTRING_PLAYER_NAME", noop);
+        define(0x8509B634FBE7DA11, "HUD::BEGIN_TEXT_COMMAND_DISPLAY_HELP", noop);
+        define(0x25FBB336DF1804CB, "HUD::BEGIN_TEXT_COMMAND_DISPLAY_TEXT", noop);
+        define(0x202709F4C58A0424, "HUD::BEGIN_TEXT_COMMAND_THEFEED_POST", noop);
+        define(0x238FFE5C7B0498A6, "HUD::END_TEXT_COMMAND_DISPLAY_HELP", noop);
+        define(0xCD015E5BB0D96A57, "HUD::END_TEXT_COMMAND_DISPLAY_TEXT", noop);
+        define(0xBE4390CB40B3E627, "HUD::THEFEED_REMOVE_ITEM", noop);
+        define(0xC02F4DBFB51D988B, "HUD::SET_TEXT_CENTRE", noop);
+        define(0xBE6B23FFA53FB442, "HUD::SET_TEXT_COLOUR", noop);
+        define(0x66E0276CC5F6B9DA, "HUD::SET_TEXT_FONT", noop);
+        define(0x2513DFB0FB8400FE, "HUD::SET_TEXT_OUTLINE", noop);
+        define(0x07C837F9A01C34C9, "HUD::SET_TEXT_SCALE", noop);
+        define(0x63145D9C883A1A70, "HUD::SET_TEXT_WRAP", noop);
+
+        return natives;
+    }
+
+    std::unordered_map<uint64_t, SNative> natives = buildNatives();
+}
+
+Standin::SWorldState& Standin::World() {
+    return world;
+}
+
+void Standin::Advance() {
+    SVehicleState& vehicle = world.Vehicle;
+    const float dt = world.FrameTime;
+    vehicle.Position = add(vehicle.Position,
+        { vehicle.Velocity.x * dt, vehicle.Velocity.y * dt, vehicle.Velocity.z * dt });
+
+    constexpr float rad2deg = 180.0f / std::numbers::pi_v<float>;
+    vehicle.Rotation.x += vehicle.RotationVelocity.x * rad2deg * dt;
+    vehicle.Rotation.y += vehicle.RotationVelocity.y * rad2deg * dt;
+    vehicle.Rotation.z += vehicle.RotationVelocity.z * rad2deg * dt;
+    vehicle.Rotation.z = std::fmod(vehicle.Rotation.z + 540.0f, 360.0f) - 180.0f;
+}
+
+Vector3 Standin::SpeedVector(const SVehicleState& vehicle) {
+    return toVehicleDirection(vehicle, vehicle.Velocity);
+}
+
+std::vector<Standin::SNativeCount> Standin::NativeCounts() {
+    std::vector<SNativeCount> counts;
+    for (const auto& [hash, native] : natives) {
+        if (native.Calls > 0) {
+            counts.push_back({ hash, native.Name, native.Calls });
+        }
+    }
+    std::sort(counts.begin(), counts.end(), [](const auto& a, const auto& b) {
+        return a.Calls > b.Calls;
+    });
+    return counts;
+}
+
+uint64_t Standin::NativeCallTotal() {
+    uint64_t total = 0;
+    for (const auto& [hash, native] : natives) {
+        total += native.Calls;
+    }
+    return total;
+}
+
+void Standin::ResetNativeCounts() {
+    for (auto& [hash, native] : natives) {
+        native.Calls = 0;
+    }
+}
+
+// The ScriptHookV exports, see inc/main.h
+
+void nativeInit(UINT64 hash) {
+    // Unknown natives are added without a handler, so they're still counted.
+    currentNative = &natives[hash];
+    currentCall.ArgCount = 0;
+}
+
+void nativePush64(UINT64 value) {
+    if (currentCall.ArgCount < currentCall.Args.size()) {
+        currentCall.Args[currentCall.ArgCount++] = value;
+    }
+}
+
+PUINT64 nativeCall() {
+    result.fill(0);
+    ++currentNative->Calls;
+    if (currentNative->Handler) {
+        currentNative->Handler(currentCall);
+    }
+    return result.data();
+}
+
+eGameVersion getGameVersion() {
+    return static_cast<eGameVersion>(world.GameVersion);
+}
+
+void scriptWait(DWORD) {}
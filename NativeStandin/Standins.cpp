@@ -0,0 +1,85 @@
+// Stand-ins for the parts of the script that read game memory or talk to
+// other mods. Backed by Standin::World() instead.
+
+#include "NativeStandin.hpp"
+
+#include <Compatibility.hpp>
+#include <Memory/MemoryAccess.hpp>
+#include <Memory/VehicleExtensions.hpp>
+#include <Util/AddonSpawnerCache.hpp>
+#include <Util/Paths.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+    // Only the FPV camera offsets CVehicleMetaData reads, at the offsets
+    // for game versions >= 1290.
+    constexpr size_t fpvCamOffset = 0x450;
+    alignas(16) std::array<uint8_t, 0x500> modelInfo{};
+
+    uintptr_t getModelInfo(unsigned int modelHash, int*) {
+        const auto& vehicle = Standin::World().Vehicle;
+        if (modelHash != vehicle.Model) {
+            return 0;
+        }
+        const float offsets[3] = { vehicle.CamSeatOffset.x, vehicle.CamSeatOffset.y, vehicle.CamSeatOffset.z };
+        std::memcpy(&modelInfo[fpvCamOffset], offsets, sizeof(offsets));
+        std::memcpy(&modelInfo[fpvCamOffset + 0x30], &vehicle.RollbarOffset, sizeof(float));
+        return reinterpret_cast<uintptr_t>(modelInfo.data());
+    }
+
+    uintptr_t getAddressOfEntity(int) {
+        return 0;
+    }
+}
+
+uintptr_t(*Memory::GetAddressOfEntity)(int entity) = getAddressOfEntity;
+uintptr_t(*Memory::GetModelInfo)(unsigned int modelHash, int* index) = getModelInfo;
+
+float Memory::GetTimeScale() {
+    return Standin::World().TimeScale;
+}
+
+void VehicleExtensions::InvalidateAddressCache() {}
+
+float VehicleExtensions::GetHoverTransformRatio(Vehicle) {
+    return Standin::World().Vehicle.HoverTransformRatio;
+}
+
+float VehicleExtensions::GetRPM(Vehicle) {
+    return Standin::World().Vehicle.RPM;
+}
+
+void VehicleExtensions::GetWheelData(Vehicle, SWheelData& wheels) {
+    const auto& states = Standin::World().Vehicle.Wheels;
+    wheels.Count = static_cast<uint8_t>(std::min<size_t>(states.size(), SWheelData::MaxWheels));
+    for (uint8_t i = 0; i < wheels.Count; ++i) {
+        wheels.Compression[i] = states[i].Compression;
+        wheels.Material[i] = states[i].Material;
+        wheels.OnGround[i] = states[i].Compression > 0.0f;
+    }
+}
+
+std::filesystem::path Paths::GetModPath() {
+    return Standin::World().ModPath;
+}
+
+const std::unordered_map<Hash, std::string>& ASCache::Get() {
+    static const std::unordered_map<Hash, std::string> empty;
+    return empty;
+}
+
+std::string ASCache::GetCachedModelName(Hash) {
+    return {};
+}
+
+bool Dismemberment::Available() { return false; }
+void Dismemberment::AddBoneDraw(int, int, int) {}
+void Dismemberment::RemoveBoneDraw(int) {}
+
+bool MT::Available() { return false; }
+bool MT::LookingLeft() { return false; }
+bool MT::LookingRight() { return false; }
+bool MT::LookingBack() { return false; }
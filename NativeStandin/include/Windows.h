@@ -0,0 +1,76 @@
+#pragma once
+// Just enough of Windows.h for the ScriptHookV SDK headers and the few
+// Win32 calls in the shared sources, so they build against the native stand-in.
+#include <cstdint>
+#include <cwchar>
+
+typedef uint32_t DWORD;
+typedef uint16_t WORD;
+typedef uint8_t BYTE;
+typedef int BOOL;
+typedef uint64_t UINT64;
+typedef UINT64* PUINT64;
+typedef void* HMODULE;
+typedef wchar_t* PWSTR;
+typedef long HRESULT;
+
+#define TRUE 1
+#define FALSE 0
+#define MAXDWORD 0xffffffff
+#define CP_UTF8 65001
+
+#ifndef __declspec
+#define __declspec(x)
+#endif
+
+// UTF-8 only, which is all StrUtil uses. wchar_t holds full code points here.
+inline int WideCharToMultiByte(unsigned, DWORD, const wchar_t* wstr, int wlen,
+    char* str, int len, const char*, BOOL*) {
+    int size = 0;
+    auto put = [&](unsigned char c) {
+        if (str && size < len) {
+            str[size] = static_cast<char>(c);
+        }
+        ++size;
+    };
+    for (int i = 0; i < wlen; ++i) {
+        auto c = static_cast<uint32_t>(wstr[i]);
+        if (c < 0x80) {
+            put(static_cast<unsigned char>(c));
+        }
+        else if (c < 0x800) {
+            put(0xC0 | (c >> 6));
+            put(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000) {
+            put(0xE0 | (c >> 12));
+            put(0x80 | ((c >> 6) & 0x3F));
+            put(0x80 | (c & 0x3F));
+        }
+        else {
+            put(0xF0 | (c >> 18));
+            put(0x80 | ((c >> 12) & 0x3F));
+            put(0x80 | ((c >> 6) & 0x3F));
+            put(0x80 | (c & 0x3F));
+        }
+    }
+    return size;
+}
+
+inline int MultiByteToWideChar(unsigned, DWORD, const char* str, int len, wchar_t* wstr, int wlen) {
+    int size = 0;
+    for (int i = 0; i < len;) {
+        auto c = static_cast<unsigned char>(str[i]);
+        int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        uint32_t codePoint = extra == 0 ? c : c & (0x3F >> extra);
+        for (int k = 1; k <= extra && i + k < len; ++k) {
+            codePoint = (codePoint << 6) | (static_cast<unsigned char>(str[i + k]) & 0x3F);
+        }
+        i += extra + 1;
+        if (wstr && size < wlen) {
+            wstr[size] = static_cast<wchar_t>(codePoint);
+        }
+        ++size;
+    }
+    return size;
+}
@@ -0,0 +1,3 @@
+#pragma once
+// The SDK includes both spellings.
+#include "Windows.h"